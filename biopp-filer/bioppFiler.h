@@ -36,6 +36,10 @@ DEFINE_SPECIFIC_EXCEPTION(InvalidSequenceError, BioppFilerException);
 }
 
 #include "formatFasta/fastaSaver.h"
+#include "formatFasta/concurrentFastaSaver.h"
 #include "formatFasta/fastaParser.h"
+#include "formatFasta/fastaCollection.h"
+#include "formatFasta/fastaSorter.h"
+#include "formatFasta/kmerScanner.h"
 
 #endif
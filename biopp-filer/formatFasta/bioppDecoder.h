@@ -0,0 +1,100 @@
+/*
+bioppDecoder.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef BIOPP_DECODER_H
+#define BIOPP_DECODER_H
+
+#include <biopp/biopp.h>
+#include "sequenceDecoder.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Direct decoders for the biopp sequence types. This header is opt-in, so
+ * that the library itself does not depend on biopp: include it before
+ * parsing or loading biopp sequences to replace the string constructor by
+ * a single table driven pass that fills the sequence in place. Like the
+ * other formatFasta headers, it expects bioppFiler.h to be included first.
+ */
+
+/*
+ * Maps every byte to its normalized residue (upper case, and T->U for
+ * nucleotides), or to 0 when the alphabet does not accept it.
+ */
+class ResidueTable
+{
+public:
+
+    inline explicit ResidueTable(const char* residues, bool thymineToUracil);
+
+    inline char operator[](char c) const;
+
+    /*
+     * Fills 'sequence' with the normalized residues of 'raw'; throws
+     * InvalidSequenceError on the first residue out of the alphabet.
+     */
+    template<class SequenceType>
+    inline void fill(const StringView& raw, SequenceType& sequence) const;
+
+    /*
+     * Same as above, but returns false and the reason in 'error' instead of
+     * throwing.
+     */
+    template<class SequenceType>
+    inline bool tryFill(const StringView& raw, SequenceType& sequence, std::string& error) const;
+
+    static inline const ResidueTable& nucleotides();
+    static inline const ResidueTable& pseudonucleotides();
+    static inline const ResidueTable& aminoacids();
+
+private:
+
+    char table[256];
+};
+
+template<>
+struct SequenceDecoder<biopp::NucSequence>
+{
+    static inline void decode(const StringView& raw, biopp::NucSequence& sequence);
+    static inline bool tryDecode(const StringView& raw, biopp::NucSequence& sequence, std::string& error);
+};
+
+template<>
+struct SequenceDecoder<biopp::PseudonucSequence>
+{
+    static inline void decode(const StringView& raw, biopp::PseudonucSequence& sequence);
+    static inline bool tryDecode(const StringView& raw, biopp::PseudonucSequence& sequence, std::string& error);
+};
+
+template<>
+struct SequenceDecoder<biopp::AminoSequence>
+{
+    static inline void decode(const StringView& raw, biopp::AminoSequence& sequence);
+    static inline bool tryDecode(const StringView& raw, biopp::AminoSequence& sequence, std::string& error);
+};
+}
+
+#define BIOPP_DECODER_INLINE_H
+#include "bioppDecoder_inline.h"
+#undef BIOPP_DECODER_INLINE_H
+#endif
@@ -0,0 +1,125 @@
+/*
+bioppDecoder_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef BIOPP_DECODER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <cctype>
+
+namespace bioppFiler
+{
+
+inline ResidueTable::ResidueTable(const char* residues, bool thymineToUracil)
+{
+    for (unsigned int c = 0; c < 256; ++c)
+        table[c] = 0;
+
+    for (; *residues != '\0'; ++residues)
+    {
+        const char residue = (thymineToUracil && *residues == 'T') ? 'U' : *residues;
+        table[static_cast<unsigned char>(*residues)] = residue;
+        table[static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(*residues)))] = residue;
+    }
+}
+
+inline char ResidueTable::operator[](char c) const
+{
+    return table[static_cast<unsigned char>(c)];
+}
+
+template<class SequenceType>
+inline void ResidueTable::fill(const StringView& raw, SequenceType& sequence) const
+{
+    std::string error;
+    if (!tryFill(raw, sequence, error))
+        throw InvalidSequenceError(error);
+}
+
+template<class SequenceType>
+inline bool ResidueTable::tryFill(const StringView& raw, SequenceType& sequence, std::string& error) const
+{
+    sequence.clear();
+    sequence.reserve(raw.size());
+
+    for (StringView::const_iterator it = raw.begin(); it != raw.end(); ++it)
+    {
+        const char residue = (*this)[*it];
+        if (residue == 0)
+        {
+            error = std::string("invalid residue '") + *it + "'";
+            return false;
+        }
+        sequence.push_back(residue);
+    }
+    return true;
+}
+
+inline const ResidueTable& ResidueTable::nucleotides()
+{
+    static const ResidueTable table("ACGTUN", true);
+    return table;
+}
+
+inline const ResidueTable& ResidueTable::pseudonucleotides()
+{
+    static const ResidueTable table("ACGTUNRYKMSWBDHV-", true);
+    return table;
+}
+
+inline const ResidueTable& ResidueTable::aminoacids()
+{
+    static const ResidueTable table("ACDEFGHIKLMNPQRSTVWYBZXJUO*-", false);
+    return table;
+}
+
+inline void SequenceDecoder<biopp::NucSequence>::decode(const StringView& raw, biopp::NucSequence& sequence)
+{
+    ResidueTable::nucleotides().fill(raw, sequence);
+}
+
+inline bool SequenceDecoder<biopp::NucSequence>::tryDecode(const StringView& raw, biopp::NucSequence& sequence, std::string& error)
+{
+    return ResidueTable::nucleotides().tryFill(raw, sequence, error);
+}
+
+inline void SequenceDecoder<biopp::PseudonucSequence>::decode(const StringView& raw, biopp::PseudonucSequence& sequence)
+{
+    ResidueTable::pseudonucleotides().fill(raw, sequence);
+}
+
+inline bool SequenceDecoder<biopp::PseudonucSequence>::tryDecode(const StringView& raw, biopp::PseudonucSequence& sequence, std::string& error)
+{
+    return ResidueTable::pseudonucleotides().tryFill(raw, sequence, error);
+}
+
+inline void SequenceDecoder<biopp::AminoSequence>::decode(const StringView& raw, biopp::AminoSequence& sequence)
+{
+    ResidueTable::aminoacids().fill(raw, sequence);
+}
+
+inline bool SequenceDecoder<biopp::AminoSequence>::tryDecode(const StringView& raw, biopp::AminoSequence& sequence, std::string& error)
+{
+    return ResidueTable::aminoacids().tryFill(raw, sequence, error);
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+concurrentFastaSaver.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef CONCURRENT_FASTA_SAVER_H
+#define CONCURRENT_FASTA_SAVER_H
+
+#include <string>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include "fastaFormatter.h"
+#include "mpscQueue.h"
+
+namespace bioppFiler
+{
+
+/*
+ * FastaSaver that may be called from many threads at once. Every record is
+ * formatted by the calling thread and handed through a lock-free queue to a
+ * single writer thread which owns the file. Records and their text buffers
+ * are recycled: the writer hands them back to a spare list, from which
+ * every saving thread refills a small thread local cache.
+ *
+ * In Ordered mode records are written by sequence number (0, 1, 2, ...);
+ * the overloads without a number take the next one in call order, so do not
+ * mix both kinds of calls on the same saver.
+ */
+template<class SequenceType>
+class ConcurrentFastaSaver
+{
+public:
+
+    typedef unsigned long long SequenceNumber;
+
+    enum Order
+    {
+        Unordered,
+        Ordered
+    };
+
+    inline ConcurrentFastaSaver(const std::string& file_name, Order order = Unordered);
+    inline ~ConcurrentFastaSaver();
+
+    inline void saveNextSequence(const std::string& title, const SequenceType& seq);
+    inline void saveNextSequence(const SequenceType& seq);
+    inline void saveNextSequence(SequenceNumber number, const std::string& title, const SequenceType& seq);
+    inline void saveNextSequence(SequenceNumber number, const SequenceType& seq);
+
+    /*
+     * Waits for every record already saved to be written. No thread may be
+     * saving concurrently with close(), and saving after it throws.
+     */
+    inline void close();
+
+private:
+
+    struct Record
+    {
+        std::atomic<Record*> next; // MpscQueue link
+        SequenceNumber       number;
+        std::string          text;
+
+        Record()
+            : next(NULL), number(0)
+        {}
+    };
+
+    /*
+     * Records ready for reuse by the saving thread; deleted when it ends.
+     */
+    struct Cache
+    {
+        std::vector<Record*> records;
+        ~Cache()
+        {
+            for (size_t i = 0; i < records.size(); ++i)
+                delete records[i];
+        }
+    };
+
+    ConcurrentFastaSaver(const ConcurrentFastaSaver&);
+    ConcurrentFastaSaver& operator=(const ConcurrentFastaSaver&);
+
+    inline Record* acquire(SequenceNumber number);
+    inline void publish(Record* record);
+    inline void write(Record* record, std::vector<Record*>& written);
+    inline void recycle(std::vector<Record*>& written);
+    inline void writer();
+    static inline std::vector<Record*>& localCache();
+
+    std::ofstream                        os;
+    const Order                          order;
+    MpscQueue<Record>                    queue;
+    std::atomic<SequenceNumber>          nextNumber;
+    std::atomic<bool>                    closing;
+    std::map<SequenceNumber, Record*>    pending;   // writer thread only
+    SequenceNumber                       nextToWrite; // writer thread only
+    std::mutex                           spareLock;
+    std::vector<Record*>                 spare;     // written, ready for reuse
+    std::thread                          writerThread;
+    static const unsigned int lineLimit = 50;
+    static const size_t       cacheRefill = 32;
+};
+}
+
+#define CONCURRENT_FASTA_SAVER_INLINE_H
+#include "concurrentFastaSaver_inline.h"
+#undef CONCURRENT_FASTA_SAVER_INLINE_H
+#endif
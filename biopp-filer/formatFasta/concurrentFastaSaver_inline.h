@@ -0,0 +1,212 @@
+/*
+concurrentFastaSaver_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef CONCURRENT_FASTA_SAVER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <chrono>
+
+namespace bioppFiler
+{
+
+template<class SequenceType>
+inline ConcurrentFastaSaver<SequenceType>::ConcurrentFastaSaver(const std::string& file_name, Order ord)
+    : os(file_name.c_str(), std::ios::out | std::ios::binary),
+      order(ord),
+      nextNumber(0),
+      closing(false),
+      nextToWrite(0)
+{
+    if (!os.is_open())
+        throw FileError(file_name);
+
+    writerThread = std::thread(&ConcurrentFastaSaver::writer, this);
+}
+
+template<class SequenceType>
+inline ConcurrentFastaSaver<SequenceType>::~ConcurrentFastaSaver()
+{
+    close();
+
+    for (size_t i = 0; i < spare.size(); ++i)
+        delete spare[i];
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::saveNextSequence(const std::string& title, const SequenceType& seq)
+{
+    saveNextSequence(nextNumber.fetch_add(1, std::memory_order_relaxed), title, seq);
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::saveNextSequence(const SequenceType& seq)
+{
+    saveNextSequence(nextNumber.fetch_add(1, std::memory_order_relaxed), seq);
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::saveNextSequence(SequenceNumber number, const std::string& title, const SequenceType& seq)
+{
+    Record* const record = acquire(number);
+    FastaFormatter::appendDescription(title, record->text);
+    FastaFormatter::appendSequence(seq.getString(), lineLimit, record->text);
+    publish(record);
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::saveNextSequence(SequenceNumber number, const SequenceType& seq)
+{
+    Record* const record = acquire(number);
+    FastaFormatter::appendEmptyLine(record->text);
+    FastaFormatter::appendSequence(seq.getString(), lineLimit, record->text);
+    publish(record);
+}
+
+template<class SequenceType>
+inline std::vector<typename ConcurrentFastaSaver<SequenceType>::Record*>& ConcurrentFastaSaver<SequenceType>::localCache()
+{
+    static thread_local Cache cache;
+    return cache.records;
+}
+
+template<class SequenceType>
+inline typename ConcurrentFastaSaver<SequenceType>::Record* ConcurrentFastaSaver<SequenceType>::acquire(SequenceNumber number)
+{
+    if (closing.load(std::memory_order_acquire))
+        throw BioppFilerException("ConcurrentFastaSaver, saving after close()");
+
+    std::vector<Record*>& cache = localCache();
+    if (cache.empty())
+    {
+        std::lock_guard<std::mutex> lock(spareLock);
+        const size_t taken = spare.size() < cacheRefill ? spare.size() : cacheRefill;
+        cache.insert(cache.end(), spare.end() - taken, spare.end());
+        spare.resize(spare.size() - taken);
+    }
+
+    Record* record;
+    if (cache.empty())
+        record = new Record;
+    else
+    {
+        // the text keeps its capacity from the previous use
+        record = cache.back();
+        cache.pop_back();
+        record->text.clear();
+    }
+
+    record->number = number;
+    return record;
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::publish(Record* record)
+{
+    queue.push(record);
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::close()
+{
+    if (writerThread.joinable())
+    {
+        closing.store(true, std::memory_order_release);
+        writerThread.join();
+        os.close();
+    }
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::write(Record* record, std::vector<Record*>& written)
+{
+    os.write(record->text.data(), record->text.size());
+    written.push_back(record);
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::recycle(std::vector<Record*>& written)
+{
+    if (!written.empty())
+    {
+        std::lock_guard<std::mutex> lock(spareLock);
+        spare.insert(spare.end(), written.begin(), written.end());
+        written.clear();
+    }
+}
+
+template<class SequenceType>
+inline void ConcurrentFastaSaver<SequenceType>::writer()
+{
+    Record* record;
+    std::vector<Record*> written;
+    unsigned int idle = 0;
+    bool done = false;
+
+    while (!done)
+    {
+        // closing is checked before popping: anything published before
+        // close() is then guaranteed to be drained by this last round
+        const bool lastRound = closing.load(std::memory_order_acquire);
+        bool popped = false;
+
+        while ((record = queue.pop()) != NULL)
+        {
+            popped = true;
+
+            if (order == Unordered)
+                write(record, written);
+            else
+            {
+                pending[record->number] = record;
+
+                typename std::map<SequenceNumber, Record*>::iterator it;
+                while (!pending.empty() && (it = pending.begin())->first == nextToWrite)
+                {
+                    write(it->second, written);
+                    pending.erase(it);
+                    ++nextToWrite;
+                }
+            }
+        }
+
+        recycle(written);
+
+        if (popped)
+            idle = 0;
+        else if (lastRound)
+            done = true;
+        else if (++idle < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // numbering gaps: flush the rest as they come
+    for (typename std::map<SequenceNumber, Record*>::iterator it = pending.begin(); it != pending.end(); ++it)
+        write(it->second, written);
+    pending.clear();
+    recycle(written);
+    os.flush();
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+fastaCollection.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_COLLECTION_H
+#define FASTA_COLLECTION_H
+
+#include <string>
+#include <vector>
+#include "fastaMachine.h"
+#include "fastaLine.h"
+#include "stringView.h"
+#include "sequenceDecoder.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Whole fasta file held in columnar form: every description and every
+ * sequence is packed in one contiguous buffer, and records are located
+ * through offset arrays. Access by index is O(1) and returns views.
+ */
+template<class SequenceType>
+class FastaCollection
+{
+public:
+
+    typedef size_t SizeType;
+
+    inline FastaCollection();
+
+    /*
+     * load() appends the records of file_name, parsing it with 'threads'
+     * threads; threads == 0 means one per hardware thread.
+     */
+    inline FastaCollection(const std::string& file_name, unsigned int threads = 0);
+
+    inline void load(const std::string& file_name, unsigned int threads = 0);
+    inline void addSequence(const std::string& description, const std::string& sequence);
+    inline void clear();
+
+    inline SizeType size() const;
+    inline bool empty() const;
+
+    inline StringView getDescription(SizeType i) const;
+    inline StringView getSequenceView(SizeType i) const;
+    inline SequenceType getSequence(SizeType i) const;
+
+private:
+
+    /*
+     * Records of one region of the file, parsed by one thread.
+     */
+    struct Chunk
+    {
+        std::string           descriptions;
+        std::string           sequences;
+        std::vector<SizeType> descriptionEnds;
+        std::vector<SizeType> sequenceEnds;
+
+        void swap(Chunk& other)
+        {
+            descriptions.swap(other.descriptions);
+            sequences.swap(other.sequences);
+            descriptionEnds.swap(other.descriptionEnds);
+            sequenceEnds.swap(other.sequenceEnds);
+        }
+    };
+
+    static inline void parseChunk(const char* begin, const char* end, Chunk& chunk);
+    static inline bool nextLine(const char*& position, const char* end, std::string& line);
+    static inline void findChunkLimits(const std::string& buffer, unsigned int chunks, std::vector<SizeType>& limits);
+    inline void append(const Chunk& chunk);
+
+    std::string           descriptions;
+    std::string           sequences;
+    std::vector<SizeType> descriptionOffsets; // size() + 1 entries
+    std::vector<SizeType> sequenceOffsets;    // size() + 1 entries
+};
+}
+
+#define FASTA_COLLECTION_INLINE_H
+#include "fastaCollection_inline.h"
+#undef FASTA_COLLECTION_INLINE_H
+#endif
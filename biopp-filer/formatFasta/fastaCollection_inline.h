@@ -0,0 +1,268 @@
+/*
+fastaCollection_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_COLLECTION_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <exception>
+
+namespace bioppFiler
+{
+
+template<class SequenceType>
+inline FastaCollection<SequenceType>::FastaCollection()
+    : descriptionOffsets(1, 0),
+      sequenceOffsets(1, 0)
+{}
+
+template<class SequenceType>
+inline FastaCollection<SequenceType>::FastaCollection(const std::string& file_name, unsigned int threads)
+    : descriptionOffsets(1, 0),
+      sequenceOffsets(1, 0)
+{
+    load(file_name, threads);
+}
+
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::load(const std::string& file_name, unsigned int threads)
+{
+    std::ifstream is(file_name.c_str(), std::ios::in | std::ios::binary);
+    if (!is.is_open())
+        throw FileNotFound(file_name);
+
+    std::string buffer;
+    is.seekg(0, std::ios::end);
+    buffer.resize(static_cast<SizeType>(is.tellg()));
+    is.seekg(0, std::ios::beg);
+    if (!buffer.empty() && !is.read(&buffer[0], buffer.size()))
+        throw FileError(file_name);
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<SizeType> limits;
+    findChunkLimits(buffer, threads, limits);
+
+    const SizeType chunkCount = limits.size() - 1;
+    std::vector<Chunk> chunks(chunkCount);
+    std::vector<std::exception_ptr> errors(chunkCount);
+    std::vector<std::thread> workers;
+
+    for (SizeType i = 1; i < chunkCount; ++i)
+    {
+        workers.push_back(std::thread([&, i]()
+        {
+            try
+            {
+                parseChunk(buffer.data() + limits[i], buffer.data() + limits[i + 1], chunks[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }));
+    }
+
+    try
+    {
+        parseChunk(buffer.data() + limits[0], buffer.data() + limits[1], chunks[0]);
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception();
+    }
+
+    for (SizeType i = 0; i < workers.size(); ++i)
+        workers[i].join();
+
+    for (SizeType i = 0; i < chunkCount; ++i)
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+
+    // the raw file is no longer needed: release it before packing the chunks
+    std::string().swap(buffer);
+
+    SizeType descriptionBytes = 0;
+    SizeType sequenceBytes = 0;
+    SizeType records = 0;
+    for (SizeType i = 0; i < chunkCount; ++i)
+    {
+        descriptionBytes += chunks[i].descriptions.size();
+        sequenceBytes += chunks[i].sequences.size();
+        records += chunks[i].sequenceEnds.size();
+    }
+
+    descriptions.reserve(descriptions.size() + descriptionBytes);
+    sequences.reserve(sequences.size() + sequenceBytes);
+    descriptionOffsets.reserve(descriptionOffsets.size() + records);
+    sequenceOffsets.reserve(sequenceOffsets.size() + records);
+
+    for (SizeType i = 0; i < chunkCount; ++i)
+    {
+        append(chunks[i]);
+        Chunk().swap(chunks[i]); // frees it as soon as it is packed
+    }
+}
+
+/*
+ * Splits the buffer in at most 'chunks' regions. Every region but the first
+ * one starts at a description line, so each can be parsed from scratch.
+ */
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::findChunkLimits(const std::string& buffer, unsigned int chunks, std::vector<SizeType>& limits)
+{
+    limits.push_back(0);
+
+    for (unsigned int i = 1; i < chunks; ++i)
+    {
+        const SizeType from = std::max(limits.back(), buffer.size() / chunks * i);
+        const SizeType found = buffer.find("\n>", from);
+
+        if (found == std::string::npos)
+            break;
+
+        limits.push_back(found + 1);
+    }
+
+    limits.push_back(buffer.size());
+}
+
+template<class SequenceType>
+inline bool FastaCollection<SequenceType>::nextLine(const char*& position, const char* end, std::string& line)
+{
+    if (position == end)
+        return false;
+
+    const char* lineEnd = std::find(position, end, '\n');
+    line.assign(position, lineEnd);
+    position = (lineEnd == end) ? end : lineEnd + 1;
+
+    return true;
+}
+
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::parseChunk(const char* begin, const char* end, Chunk& chunk)
+{
+    FastaMachine fsm;
+    std::string line;
+    std::string description;
+    std::string sequence;
+    bool valid;
+
+    do
+    {
+        description.clear();
+        sequence.clear();
+        fsm.setCurrentSequence(sequence, description);
+
+        do
+        {
+            if (nextLine(begin, end, line))
+                FastaLine::stimulate(fsm, line);
+            else
+                fsm.eof();
+        }
+        while (fsm.keepRunning());
+
+        valid = fsm.isValidSequence();
+        if (valid)
+        {
+            chunk.descriptions += description;
+            chunk.sequences += sequence;
+            chunk.descriptionEnds.push_back(chunk.descriptions.size());
+            chunk.sequenceEnds.push_back(chunk.sequences.size());
+        }
+    }
+    while (valid);
+}
+
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::append(const Chunk& chunk)
+{
+    const SizeType descriptionBase = descriptions.size();
+    const SizeType sequenceBase = sequences.size();
+
+    descriptions += chunk.descriptions;
+    sequences += chunk.sequences;
+
+    for (SizeType i = 0; i < chunk.sequenceEnds.size(); ++i)
+    {
+        descriptionOffsets.push_back(descriptionBase + chunk.descriptionEnds[i]);
+        sequenceOffsets.push_back(sequenceBase + chunk.sequenceEnds[i]);
+    }
+}
+
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::addSequence(const std::string& description, const std::string& sequence)
+{
+    descriptions += description;
+    sequences += sequence;
+    descriptionOffsets.push_back(descriptions.size());
+    sequenceOffsets.push_back(sequences.size());
+}
+
+template<class SequenceType>
+inline void FastaCollection<SequenceType>::clear()
+{
+    descriptions.clear();
+    sequences.clear();
+    descriptionOffsets.assign(1, 0);
+    sequenceOffsets.assign(1, 0);
+}
+
+template<class SequenceType>
+inline typename FastaCollection<SequenceType>::SizeType FastaCollection<SequenceType>::size() const
+{
+    return sequenceOffsets.size() - 1;
+}
+
+template<class SequenceType>
+inline bool FastaCollection<SequenceType>::empty() const
+{
+    return size() == 0;
+}
+
+template<class SequenceType>
+inline StringView FastaCollection<SequenceType>::getDescription(SizeType i) const
+{
+    return StringView(descriptions.data() + descriptionOffsets[i], descriptionOffsets[i + 1] - descriptionOffsets[i]);
+}
+
+template<class SequenceType>
+inline StringView FastaCollection<SequenceType>::getSequenceView(SizeType i) const
+{
+    return StringView(sequences.data() + sequenceOffsets[i], sequenceOffsets[i + 1] - sequenceOffsets[i]);
+}
+
+template<class SequenceType>
+inline SequenceType FastaCollection<SequenceType>::getSequence(SizeType i) const
+{
+    SequenceType sequence;
+    SequenceDecoder<SequenceType>::decode(getSequenceView(i), sequence);
+    return sequence;
+}
+
+}
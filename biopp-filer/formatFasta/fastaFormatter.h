@@ -0,0 +1,57 @@
+/*
+fastaFormatter.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_FORMATTER_H
+#define FASTA_FORMATTER_H
+
+#include <string>
+#include "sequenceTransform.h"
+#include "softMask.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Renders records as fasta text into a buffer, so that the same layout is
+ * shared by every saver.
+ */
+class FastaFormatter
+{
+public:
+
+    static inline void appendDescription(const std::string& des, std::string& out);
+    static inline void appendSequence(const std::string& seq, unsigned int lineLimit, std::string& out);
+    static inline void appendSequence(const std::string& seq, unsigned int lineLimit, const SequenceTransform& transform, std::string& out);
+    static inline void appendEmptyLine(std::string& out);
+
+    /*
+     * Same layout, with the residues under 'mask' (positions of seq) taken
+     * as soft masked by the transform.
+     */
+    static inline void appendSequence(const std::string& seq, unsigned int lineLimit, const SequenceTransform& transform, const SoftMask& mask, std::string& out);
+};
+}
+
+#define FASTA_FORMATTER_INLINE_H
+#include "fastaFormatter_inline.h"
+#undef FASTA_FORMATTER_INLINE_H
+#endif
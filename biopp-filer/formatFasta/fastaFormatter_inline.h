@@ -0,0 +1,99 @@
+/*
+fastaFormatter_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_FORMATTER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <algorithm>
+
+namespace bioppFiler
+{
+
+inline void FastaFormatter::appendDescription(const std::string& des, std::string& out)
+{
+    out += '>';
+    out += des;
+    out += '\n';
+}
+
+inline void FastaFormatter::appendSequence(const std::string& seq, unsigned int lineLimit, std::string& out)
+{
+    out.reserve(out.size() + seq.size() + seq.size() / lineLimit + 1);
+
+    for (size_t i = 0; i < seq.size(); i += lineLimit)
+    {
+        out.append(seq, i, lineLimit);
+        out += '\n';
+    }
+
+    // a sequence filling its last line is followed by an empty one
+    if (seq.size() % lineLimit == 0)
+        out += '\n';
+}
+
+inline void FastaFormatter::appendSequence(const std::string& seq, unsigned int lineLimit, const SequenceTransform& transform, std::string& out)
+{
+    if (transform.isIdentity())
+    {
+        appendSequence(seq, lineLimit, out);
+        return;
+    }
+
+    out.reserve(out.size() + seq.size() + seq.size() / lineLimit + 1);
+
+    for (size_t i = 0; i < seq.size(); i += lineLimit)
+    {
+        transform.apply(seq, i, std::min<size_t>(lineLimit, seq.size() - i), out);
+        out += '\n';
+    }
+
+    if (seq.size() % lineLimit == 0)
+        out += '\n';
+}
+
+inline void FastaFormatter::appendSequence(const std::string& seq, unsigned int lineLimit, const SequenceTransform& transform, const SoftMask& mask, std::string& out)
+{
+    if (mask.empty())
+    {
+        appendSequence(seq, lineLimit, transform, out);
+        return;
+    }
+
+    out.reserve(out.size() + seq.size() + seq.size() / lineLimit + 1);
+
+    for (size_t i = 0; i < seq.size(); i += lineLimit)
+    {
+        transform.apply(seq, i, std::min<size_t>(lineLimit, seq.size() - i), mask, out);
+        out += '\n';
+    }
+
+    if (seq.size() % lineLimit == 0)
+        out += '\n';
+}
+
+inline void FastaFormatter::appendEmptyLine(std::string& out)
+{
+    out += '\n';
+}
+
+}
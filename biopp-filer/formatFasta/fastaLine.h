@@ -0,0 +1,54 @@
+/*
+fastaLine.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_LINE_H
+#define FASTA_LINE_H
+
+#include <string>
+#include <mili/mili.h>
+#include "fastaMachine.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Cleans a raw line (comments, white spaces) and feeds it to the FastaMachine
+ * as the stimulus it corresponds to. Shared by every reader of the format.
+ */
+class FastaLine
+{
+public:
+
+    static inline FastaMachine::Status stimulate(FastaMachine& fsm, std::string& line);
+
+private:
+
+    static inline void removeComment(std::string& line);
+    static inline void removeFirstChar(std::string& line);
+    static inline void removeWhiteSpace(std::string& line);
+};
+}
+
+#define FASTA_LINE_INLINE_H
+#include "fastaLine_inline.h"
+#undef FASTA_LINE_INLINE_H
+#endif
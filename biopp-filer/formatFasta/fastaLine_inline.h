@@ -0,0 +1,68 @@
+/*
+fastaLine_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_LINE_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <algorithm>
+
+namespace bioppFiler
+{
+
+inline void FastaLine::removeComment(std::string& line)
+{
+    const std::string::size_type commentPosistion = line.find_first_of(";");
+    if (commentPosistion != std::string::npos)
+        line = line.substr(0, commentPosistion);
+}
+
+inline void FastaLine::removeFirstChar(std::string& line)
+{
+    line = line.substr(1, line.size());
+}
+
+inline void FastaLine::removeWhiteSpace(std::string& line)
+{
+    line = mili::trim(line);
+    line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+}
+
+inline FastaMachine::Status FastaLine::stimulate(FastaMachine& fsm, std::string& line)
+{
+    removeComment(line);
+    removeWhiteSpace(line);
+
+    if (line.empty())
+    {
+        return fsm.lineEmpty();
+    }
+    else if (line[0] == '>')
+    {
+        removeFirstChar(line);
+        return fsm.lineDescription(line);
+    }
+    else
+        return fsm.lineSequence(line);
+}
+
+}
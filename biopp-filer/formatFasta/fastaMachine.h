@@ -24,6 +24,7 @@ fastaMachine.h: load and save sequences(NucSequence, PseudonucSequence, and Amin
 #define FASTA_MACHINE_H
 
 #include <string>
+#include "recordFilter.h"
 
 namespace bioppFiler
 {
@@ -35,7 +36,37 @@ public:
     typedef std::string LineType;
     typedef std::string Sequence;
 
-    inline FastaMachine();
+    /*
+     * Strict: a malformed record throws FileError.
+     * Lenient: a malformed record is dropped, the machine resyncs at the
+     *          next description line and the stimulus returns Malformed.
+     */
+    enum Mode
+    {
+        Strict,
+        Lenient
+    };
+
+    enum Status
+    {
+        Ok,
+        Malformed
+    };
+
+    /*
+     * Receives the residue lines of the selected records as they are
+     * scanned, instead of having them gathered in the sequence buffer.
+     */
+    class ResidueSink
+    {
+    public:
+        virtual ~ResidueSink()
+        {}
+        virtual void beginSequence() = 0;
+        virtual void appendResidues(const LineType& line) = 0;
+    };
+
+    inline explicit FastaMachine(Mode mode = Strict);
     inline ~FastaMachine();
 
     inline void setCurrentSequence(Sequence& seq, LineType& des);
@@ -43,11 +74,52 @@ public:
     inline bool keepRunning() const;
     inline void reset();
 
+    /*
+     * reason of the last Malformed status
+     */
+    inline const char* getLastError() const;
+
+    /*
+     * Only records accepted by 'filter' are yielded; NULL disables filtering.
+     */
+    inline void setFilter(const RecordFilter* filter);
+
+    /*
+     * While a sink is set the yielded sequences stay empty. Length bounds
+     * still decide which records are yielded, but the sink has been fed
+     * by then: with a sink, filter records by their description.
+     */
+    inline void setResidueSink(ResidueSink* sink);
+
+    /*
+     * true while the lines being fed belong to a rejected record, whose
+     * sequence lines can then be fed empty.
+     */
+    inline bool isSkippingRecord() const;
+
+    /*
+     * true between records, where a sequence line starts a new one
+     */
+    inline bool isWaitingForDescription() const;
+
+    /*
+     * true once the description of a selected record has been read, before
+     * its first sequence line, when no length bound needs its residues: the
+     * caller may then defer them, and either go on feeding them as usual or
+     * feed them empty to skip them. The record is yielded either way.
+     */
+    inline bool canDeferSequence() const;
+
+    /*
+     * description of the record being read, before it is yielded
+     */
+    inline const LineType& getDescription() const;
+
     /***************Stimulus**************/
-    inline void lineDescription(const LineType& line);
-    inline void lineSequence(const LineType& line);
-    inline void lineEmpty();
-    inline void eof();
+    inline Status lineDescription(const LineType& line);
+    inline Status lineSequence(const LineType& line);
+    inline Status lineEmpty();
+    inline Status eof();
 
 private:
 
@@ -55,6 +127,7 @@ private:
     class WaitingForDescription;
     class WaitingForSequence;
     class ReadingSequence;
+    class SkippingRecord;
     class EndOfFile;
 
     /*
@@ -67,9 +140,24 @@ private:
      */
     inline void resetFlags();
 
+    /*
+     * throws on Strict mode, records the error on Lenient mode
+     */
+    inline void malformed(const char* reason);
+
+    /*
+     * record contents, honoring the filter
+     */
+    inline void selectRecord();
+    inline void setDescription(const LineType& line);
+    inline void setSequence(const LineType& line);
+    inline void appendSequence(const LineType& line);
+    inline void clearRecord();
+
     const State* const waitingForDescription;
     const State* const waitingForSequence;
     const State* const readingSequence;
+    const State* const skippingRecord;
     const State* const endOfFile;
     const State*       current;
 
@@ -80,6 +168,17 @@ private:
     LineType description;
 
     bool running;
+
+    const Mode  mode;
+    Status      status;
+    const char* lastError;
+
+    const RecordFilter* filter;
+    bool                selected;
+
+    ResidueSink* sink;
+    size_t       residueCount;  // of the record being read
+    size_t       yieldedLength;
 };
 }
 
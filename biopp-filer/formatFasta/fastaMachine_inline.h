@@ -79,6 +79,18 @@ public:
     inline const State* eof() const;
 };
 
+class FastaMachine::SkippingRecord : public State
+{
+public:
+    SkippingRecord(FastaMachine* fm)
+        : State(fm)
+    {}
+    inline const State* lineDescription(const LineType& line) const;
+    inline const State* lineSequence(const LineType& line) const;
+    inline const State* lineEmpty() const;
+    inline const State* eof() const;
+};
+
 class FastaMachine::EndOfFile : public State
 {
 public:
@@ -91,13 +103,22 @@ public:
     inline const State* eof() const;
 };
 
-inline FastaMachine::FastaMachine()
+inline FastaMachine::FastaMachine(Mode m)
     : waitingForDescription(new WaitingForDescription(this)),
       waitingForSequence(new WaitingForSequence(this)),
       readingSequence(new ReadingSequence(this)),
+      skippingRecord(new SkippingRecord(this)),
       endOfFile(new EndOfFile(this)),
       current(waitingForDescription),
-      running(true)
+      running(true),
+      mode(m),
+      status(Ok),
+      lastError(""),
+      filter(NULL),
+      selected(true),
+      sink(NULL),
+      residueCount(0),
+      yieldedLength(0)
 {}
 
 inline FastaMachine::~FastaMachine()
@@ -105,6 +126,7 @@ inline FastaMachine::~FastaMachine()
     delete waitingForSequence;
     delete waitingForDescription;
     delete readingSequence;
+    delete skippingRecord;
     delete endOfFile;
 }
 
@@ -112,18 +134,121 @@ inline void FastaMachine::reset()
 {
     current = waitingForDescription;
     running = true;
+    residueCount = 0;
 }
 
 inline void FastaMachine::yield()
 {
-    *currentDescription = description;
-    *currentSequence    = sequence;
-    running             = false;
+    if (filter != NULL && !(selected && filter->acceptsLength(residueCount)))
+    {
+        // rejected: keep on running until an accepted record shows up
+        clearRecord();
+        return;
+    }
+
+    // swapped, not copied: the caller gets the buffers the record was
+    // gathered in, and the machine goes on with the caller's old ones
+    currentDescription->swap(description);
+    currentSequence->swap(sequence);
+    yieldedLength = residueCount;
+    residueCount = 0;
+    running = false;
+}
+
+inline void FastaMachine::selectRecord()
+{
+    selected = (filter == NULL) || filter->acceptsDescription(description);
+}
+
+inline void FastaMachine::setDescription(const LineType& line)
+{
+    description = line;
+    selectRecord();
+}
+
+inline void FastaMachine::setSequence(const LineType& line)
+{
+    sequence.clear();
+    residueCount = 0;
+    if (sink != NULL && selected)
+        sink->beginSequence();
+    appendSequence(line);
+}
+
+inline void FastaMachine::appendSequence(const LineType& line)
+{
+    if (selected)
+    {
+        residueCount += line.size();
+        if (filter != NULL && residueCount > filter->getMaxLength())
+        {
+            selected = false;
+            sequence.clear();
+        }
+        else if (sink != NULL)
+            sink->appendResidues(line);
+        else
+            sequence += line;
+    }
+}
+
+inline void FastaMachine::clearRecord()
+{
+    sequence.clear();
+    description.clear();
+    residueCount = 0;
+}
+
+inline void FastaMachine::setResidueSink(ResidueSink* residueSink)
+{
+    sink = residueSink;
+}
+
+inline void FastaMachine::setFilter(const RecordFilter* recordFilter)
+{
+    filter   = recordFilter;
+    selected = true;
+}
+
+inline bool FastaMachine::isWaitingForDescription() const
+{
+    return current == waitingForDescription;
+}
+
+inline bool FastaMachine::canDeferSequence() const
+{
+    return selected && current == waitingForSequence && (filter == NULL || !filter->boundsLength());
+}
+
+inline const FastaMachine::LineType& FastaMachine::getDescription() const
+{
+    return description;
+}
+
+inline bool FastaMachine::isSkippingRecord() const
+{
+    return !selected && (current == readingSequence || current == waitingForSequence);
 }
 
 inline void FastaMachine::resetFlags()
 {
     running = true;
+    status  = Ok;
+}
+
+inline void FastaMachine::malformed(const char* reason)
+{
+    if (mode == Strict)
+        throw FileError(reason);
+
+    status    = Malformed;
+    lastError = reason;
+    clearRecord();
+}
+
+inline const char* FastaMachine::getLastError() const
+{
+    return lastError;
 }
 
 
@@ -131,11 +256,12 @@ inline void FastaMachine::setCurrentSequence(Sequence& seq, LineType& des)
 {
     currentSequence    = &seq;
     currentDescription = &des;
+    yieldedLength      = 0;
 }
 
 inline bool FastaMachine::isValidSequence() const
 {
-    return !currentSequence->empty();
+    return yieldedLength != 0;
 }
 
 inline bool FastaMachine::keepRunning() const
@@ -143,33 +269,37 @@ inline bool FastaMachine::keepRunning() const
     return running && (current != endOfFile);
 }
 
-inline void FastaMachine::lineDescription(const LineType& line)
+inline FastaMachine::Status FastaMachine::lineDescription(const LineType& line)
 {
     resetFlags();
     current = current->lineDescription(line);
+    return status;
 }
 
-inline void FastaMachine::lineSequence(const LineType& line)
+inline FastaMachine::Status FastaMachine::lineSequence(const LineType& line)
 {
     resetFlags();
     current = current->lineSequence(line);
+    return status;
 }
 
-inline void FastaMachine::lineEmpty()
+inline FastaMachine::Status FastaMachine::lineEmpty()
 {
     resetFlags();
     current = current->lineEmpty();
+    return status;
 }
 
-inline void FastaMachine::eof()
+inline FastaMachine::Status FastaMachine::eof()
 {
     resetFlags();
     current = current->eof();
+    return status;
 }
 
 inline const FastaMachine::State* FastaMachine::WaitingForDescription::lineDescription(const LineType& line) const
 {
-    this->fsm->description = line;
+    this->fsm->setDescription(line);
 
     return this->fsm->waitingForSequence;
 }
@@ -181,7 +311,8 @@ inline const FastaMachine::State* FastaMachine::WaitingForDescription::lineEmpty
 
 inline const FastaMachine::State* FastaMachine::WaitingForDescription::lineSequence(const LineType& line) const
 {
-    this->fsm->sequence = line;
+    this->fsm->selectRecord();
+    this->fsm->setSequence(line);
 
     return this->fsm->readingSequence;
 }
@@ -193,32 +324,40 @@ inline const FastaMachine::State* FastaMachine::WaitingForDescription::eof() con
     return this->fsm->endOfFile;
 }
 
-inline const FastaMachine::State* FastaMachine::WaitingForSequence::lineDescription(const LineType&) const
+inline const FastaMachine::State* FastaMachine::WaitingForSequence::lineDescription(const LineType& line) const
 {
-    throw FileError("WaitingForSequence, Expected lineSequence");
+    this->fsm->malformed("WaitingForSequence, Expected lineSequence");
+    this->fsm->setDescription(line);
+
+    return this;
 }
 
 inline const FastaMachine::State* FastaMachine::WaitingForSequence::lineSequence(const LineType& line) const
 {
-    this->fsm->sequence = line;
+    this->fsm->setSequence(line);
 
     return this->fsm->readingSequence;
 }
 
 inline const FastaMachine::State* FastaMachine::WaitingForSequence::lineEmpty() const
 {
-    throw FileError("WaitingForSequence, Expected lineSequence");
+    this->fsm->malformed("WaitingForSequence, Expected lineSequence");
+
+    return this->fsm->skippingRecord;
 }
 
 inline const FastaMachine::State* FastaMachine::WaitingForSequence::eof() const
 {
-    throw FileError("WaitingForSequence, Expected lineSequence");
+    this->fsm->malformed("WaitingForSequence, Expected lineSequence");
+    this->fsm->yield();
+
+    return this->fsm->endOfFile;
 }
 
 inline const FastaMachine::State* FastaMachine::ReadingSequence::lineDescription(const LineType& line) const
 {
     this->fsm->yield();
-    this->fsm->description = line;
+    this->fsm->setDescription(line);
 
     return this->fsm->waitingForSequence;
 }
@@ -226,15 +365,14 @@ inline const FastaMachine::State* FastaMachine::ReadingSequence::lineDescription
 inline const FastaMachine::State* FastaMachine::ReadingSequence::lineEmpty() const
 {
     this->fsm->yield();
-    this->fsm->description.clear();
-    this->fsm->sequence.clear();
+    this->fsm->clearRecord();
 
     return this->fsm->waitingForDescription;
 }
 
 inline const FastaMachine::State* FastaMachine::ReadingSequence::lineSequence(const LineType& line) const
 {
-    this->fsm->sequence += line;
+    this->fsm->appendSequence(line);
 
     return this;
 }
@@ -246,6 +384,30 @@ inline const FastaMachine::State* FastaMachine::ReadingSequence::eof() const
     return this->fsm->endOfFile;
 }
 
+inline const FastaMachine::State* FastaMachine::SkippingRecord::lineDescription(const LineType& line) const
+{
+    this->fsm->setDescription(line);
+
+    return this->fsm->waitingForSequence;
+}
+
+inline const FastaMachine::State* FastaMachine::SkippingRecord::lineEmpty() const
+{
+    return this;
+}
+
+inline const FastaMachine::State* FastaMachine::SkippingRecord::lineSequence(const LineType&) const
+{
+    return this;
+}
+
+inline const FastaMachine::State* FastaMachine::SkippingRecord::eof() const
+{
+    this->fsm->yield();
+
+    return this->fsm->endOfFile;
+}
+
 inline const FastaMachine::State* FastaMachine::EndOfFile::lineDescription(const LineType&) const
 {
     return this;
@@ -27,6 +27,11 @@ fastaParser.h: load and save sequences(NucSequence, PseudonucSequence, and Amino
 #include <fstream>
 #include <mili/mili.h>
 #include "fastaMachine.h"
+#include "fastaLine.h"
+#include "headerPool.h"
+#include "parseReport.h"
+#include "sequenceDecoder.h"
+#include "softMask.h"
 
 namespace bioppFiler
 {
@@ -36,21 +41,97 @@ class FastaParser
 {
 public:
 
+    class Record;   // lightweight handle to the current record
+    class iterator; // input iterator over the records
+
     inline FastaParser(const std::string& file_name);
+
+    /*
+     * Lenient parser: malformed records, and records whose residues do not
+     * convert to SequenceType, are skipped and appended to 'report' instead
+     * of throwing. The iterator skips them too, so it converts every record
+     * as it advances and its Records never throw.
+     */
+    inline FastaParser(const std::string& file_name, ParseReport& report);
     inline bool getNextSequence(std::string& description, SequenceType& sequence);
+
+    /*
+     * Same as above, but the description line is stored in 'pool', which
+     * resolves the returned handle.
+     */
+    inline bool getNextSequence(HeaderPool::HeaderId& description, SequenceType& sequence, HeaderPool& pool);
+
+    /*
+     * Same as above, but lower case regions are recorded in 'mask' and the
+     * residues are normalized to upper case before the conversion.
+     */
+    inline bool getNextSequence(std::string& description, SequenceType& sequence, SoftMask& mask);
+
+    /*
+     * Reads the next record, handing its residue lines to 'sink' as they
+     * are scanned instead of gathering them (see KmerSink): the sequence is
+     * never built. Returns false at the end of the file.
+     */
+    inline bool scanNextSequence(std::string& description, FastaMachine::ResidueSink& sink);
+
     inline void reset();
 
+    /*
+     * Records rejected by 'filter' are skipped while scanning. The filter
+     * is copied; setFilter(NULL) disables it.
+     */
+    inline void setFilter(const RecordFilter* filter);
+
+    /*
+     * Single pass range: begin() reads on from the current position, and
+     * every increment invalidates the Record previously yielded. Each
+     * increment reads the description only: the residues are gathered when
+     * the Record first asks for them, and skipped without copying if it
+     * never does. Records read while a length bound is set, or in lenient
+     * mode, are gathered at once, since their residues decide whether they
+     * are yielded.
+     */
+    inline iterator begin();
+    inline iterator end() const;
+
 private:
 
-    inline void removeComment(std::string& line);
-    inline void removeFirstChar(std::string& line);
-    inline void removeWhiteSpace(std::string& line);
+    inline bool advance();
+    inline void finishSequence(bool skip);
+    inline const std::string& gatherCurrent();
+    inline bool decode(const std::string& raw, SequenceType& sequence);
+    inline const SequenceType& decodeCurrent();
 
     inline void stimulateFastaMachine();
+    inline bool isSequenceLineAhead();
+    static inline bool isDescriptionLine(const std::string& line);
     inline bool getNextSequence(std::string& description, std::string& sequence);
 
     std::ifstream is;
     FastaMachine fsm;
+    RecordFilter filter;
+    ParseReport* const report;
+    size_t       lineNumber;
+    size_t       nextLineOffset;
+
+    /*
+     * where the record being gathered starts, and where the last yielded
+     * one started; that is what reports point at
+     */
+    struct Position
+    {
+        size_t offset;
+        size_t line;
+    };
+    Position     recordStart;
+    Position     yieldedStart;
+
+    std::string  currentDescription;
+    std::string  currentSequenceString;
+    SequenceType currentSequence;
+    bool         currentDecoded;
+    bool         sequencePending;  // the current record's residues are unread
+    bool         skippingSequence; // its residue lines are being skipped
 };
 }
 
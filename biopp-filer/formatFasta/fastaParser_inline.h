@@ -25,72 +25,234 @@ fastaParser_inline.h: load and save sequences(NucSequence, PseudonucSequence, an
 #endif
 
 #include<sstream>
+#include<iterator>
+#include<cstddef>
+#include<cctype>
+#include<limits>
 
 namespace bioppFiler
 {
 
+template<class SequenceType>
+class FastaParser<SequenceType>::Record
+{
+public:
+    Record()
+        : parser(NULL)
+    {}
+    explicit Record(FastaParser* fp)
+        : parser(fp)
+    {}
+    const std::string& getDescription() const
+    {
+        return parser->currentDescription;
+    }
+    const std::string& getSequenceString() const
+    {
+        return parser->gatherCurrent();
+    }
+    size_t length() const
+    {
+        return parser->gatherCurrent().size();
+    }
+    const SequenceType& getSequence() const
+    {
+        return parser->decodeCurrent();
+    }
+private:
+    friend class iterator;
+    FastaParser* parser;
+};
+
+template<class SequenceType>
+class FastaParser<SequenceType>::iterator
+{
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Record                  value_type;
+    typedef std::ptrdiff_t          difference_type;
+    typedef const Record*           pointer;
+    typedef const Record&           reference;
+
+    iterator()
+        : record()
+    {}
+    explicit iterator(FastaParser* fp)
+        : record(fp)
+    {
+        if (!fp->advance())
+            record = Record();
+    }
+    reference operator*() const
+    {
+        return record;
+    }
+    pointer operator->() const
+    {
+        return &record;
+    }
+    iterator& operator++()
+    {
+        if (!record.parser->advance())
+            record = Record();
+        return *this;
+    }
+    void operator++(int)
+    {
+        ++*this;
+    }
+    bool operator==(const iterator& other) const
+    {
+        return record.parser == other.record.parser;
+    }
+    bool operator!=(const iterator& other) const
+    {
+        return !(*this == other);
+    }
+private:
+    Record record;
+};
+
 template<class SequenceType>
 inline FastaParser<SequenceType>::FastaParser(const std::string& file_name)
-    : is(file_name.c_str())
+    : is(file_name.c_str()),
+      fsm(FastaMachine::Strict),
+      report(NULL),
+      lineNumber(0),
+      nextLineOffset(0),
+      recordStart(),
+      yieldedStart(),
+      currentDecoded(false),
+      sequencePending(false),
+      skippingSequence(false)
 {
     if (!is.is_open())
         throw FileNotFound(file_name);
 }
 
 template<class SequenceType>
-inline void FastaParser<SequenceType>::removeComment(std::string& line)
+inline FastaParser<SequenceType>::FastaParser(const std::string& file_name, ParseReport& parseReport)
+    : is(file_name.c_str()),
+      fsm(FastaMachine::Lenient),
+      report(&parseReport),
+      lineNumber(0),
+      nextLineOffset(0),
+      recordStart(),
+      yieldedStart(),
+      currentDecoded(false),
+      sequencePending(false),
+      skippingSequence(false)
 {
-    const std::string::size_type commentPosistion = line.find_first_of(";");
-    if (commentPosistion != std::string::npos)
-        line = line.substr(0, commentPosistion);
+    if (!is.is_open())
+        throw FileNotFound(file_name);
 }
 
 template<class SequenceType>
-inline void FastaParser<SequenceType>::removeFirstChar(std::string& line)
+inline void FastaParser<SequenceType>::stimulateFastaMachine()
 {
-    line = line.substr(1, line.size());
+    static const std::string skippedLine;
+    std::string line;
+    const Position current = {nextLineOffset, lineNumber + 1};
+    const Position previousStart = recordStart;
+    FastaMachine::Status status;
+
+    if ((skippingSequence || fsm.isSkippingRecord()) && isSequenceLineAhead())
+    {
+        // residues of a rejected or unread record: skip them without copying
+        ++lineNumber;
+        is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        nextLineOffset += is.gcount();
+        status = fsm.lineSequence(skippedLine);
+    }
+    else if (std::getline(is, line))
+    {
+        ++lineNumber;
+        nextLineOffset += line.size() + 1;
+
+        const bool description = isDescriptionLine(line);
+        const bool betweenRecords = fsm.isWaitingForDescription();
+        status = FastaLine::stimulate(fsm, line);
+
+        if (description || (betweenRecords && !line.empty()))
+            recordStart = current;
+    }
+    else
+        status = fsm.eof();
+
+    // if this stimulus yielded, the record it yielded started here
+    yieldedStart = previousStart;
+
+    if (status == FastaMachine::Malformed && report != NULL)
+        report->push_back(ParseError(previousStart.offset, previousStart.line, fsm.getLastError()));
 }
 
 template<class SequenceType>
-inline void FastaParser<SequenceType>::removeWhiteSpace(std::string& line)
+inline bool FastaParser<SequenceType>::isDescriptionLine(const std::string& line)
 {
-    line = mili::trim(line);
-    line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+    const std::string::size_type first = line.find_first_not_of(" \t");
+    return first != std::string::npos && line[first] == '>';
 }
 
 template<class SequenceType>
-inline void FastaParser<SequenceType>::stimulateFastaMachine()
+inline bool FastaParser<SequenceType>::isSequenceLineAhead()
 {
-    std::string line;
+    const int next = is.peek();
+    return next != std::char_traits<char>::eof() && next != '>' && next != ';' && !std::isspace(next);
+}
 
-    if (std::getline(is, line))
+template<class SequenceType>
+inline void FastaParser<SequenceType>::setFilter(const RecordFilter* recordFilter)
+{
+    if (recordFilter == NULL)
+        fsm.setFilter(NULL);
+    else
     {
-        removeComment(line);
-        removeWhiteSpace(line);
-
-        if (line.empty())
-        {
-            fsm.lineEmpty();
-        }
-        else if (line[0] == '>')
-        {
-            removeFirstChar(line);
-            fsm.lineDescription(line);
-        }
-        else
-            fsm.lineSequence(line);
+        filter = *recordFilter;
+        fsm.setFilter(&filter);
     }
-    else
-        fsm.eof();
 }
 
 template<class SequenceType>
 inline bool FastaParser<SequenceType>::getNextSequence(std::string& description, SequenceType& sequence)
 {
-    std::string sequenceString;//for type conversion
-    const bool result = getNextSequence(description, sequenceString);
+    bool result;
+    currentDecoded = false;
 
-    sequence = SequenceType(sequenceString);
+    do
+        result = getNextSequence(description, currentSequenceString);
+    while (!decode(currentSequenceString, sequence) && result);
+
+    return result;
+}
+
+template<class SequenceType>
+inline bool FastaParser<SequenceType>::getNextSequence(std::string& description, SequenceType& sequence, SoftMask& mask)
+{
+    bool result;
+    currentDecoded = false;
+
+    do
+    {
+        result = getNextSequence(description, currentSequenceString);
+        mask.extract(currentSequenceString);
+    }
+    while (!decode(currentSequenceString, sequence) && result);
+
+    return result;
+}
+
+template<class SequenceType>
+inline bool FastaParser<SequenceType>::getNextSequence(HeaderPool::HeaderId& description, SequenceType& sequence, HeaderPool& pool)
+{
+    bool result;
+    currentDecoded = false;
+
+    do
+        result = getNextSequence(currentDescription, currentSequenceString);
+    while (!decode(currentSequenceString, sequence) && result);
+
+    if (result)
+        description = pool.add(currentDescription);
 
     return result;
 }
@@ -98,6 +260,9 @@ inline bool FastaParser<SequenceType>::getNextSequence(std::string& description,
 template<class SequenceType>
 inline bool FastaParser<SequenceType>::getNextSequence(std::string& description, std::string& sequence)
 {
+    if (sequencePending)
+        finishSequence(true);
+
     description.clear();
     sequence.clear();
     fsm.setCurrentSequence(sequence, description);
@@ -109,12 +274,145 @@ inline bool FastaParser<SequenceType>::getNextSequence(std::string& description,
     return fsm.isValidSequence();
 }
 
+template<class SequenceType>
+inline bool FastaParser<SequenceType>::scanNextSequence(std::string& description, FastaMachine::ResidueSink& sink)
+{
+    currentDecoded = false;
+    currentSequenceString.clear();
+    fsm.setResidueSink(&sink);
+
+    bool result;
+    try
+    {
+        result = getNextSequence(description, currentSequenceString);
+    }
+    catch (...)
+    {
+        fsm.setResidueSink(NULL);
+        throw;
+    }
+
+    fsm.setResidueSink(NULL);
+    return result;
+}
+
+template<class SequenceType>
+inline bool FastaParser<SequenceType>::decode(const std::string& raw, SequenceType& sequence)
+{
+    if (report == NULL)
+    {
+        SequenceDecoder<SequenceType>::decode(StringView(raw), sequence);
+        return true;
+    }
+
+    // lenient: a record that does not convert is reported and skipped
+    std::string error;
+    if (SequenceDecoder<SequenceType>::tryDecode(StringView(raw), sequence, error))
+        return true;
+
+    report->push_back(ParseError(yieldedStart.offset, yieldedStart.line, error));
+    return false;
+}
+
+template<class SequenceType>
+inline bool FastaParser<SequenceType>::advance()
+{
+    currentDecoded = false;
+
+    // lenient: convert now, so that the records which do not convert are
+    // skipped and reported here rather than thrown by the Record
+    if (report != NULL)
+    {
+        bool result;
+        do
+            result = getNextSequence(currentDescription, currentSequenceString);
+        while (result && !decode(currentSequenceString, currentSequence));
+
+        currentDecoded = result;
+        return result;
+    }
+
+    if (sequencePending)
+        finishSequence(true);
+
+    currentDescription.clear();
+    currentSequenceString.clear();
+    fsm.setCurrentSequence(currentSequenceString, currentDescription);
+
+    for (;;)
+    {
+        // stop at the description; gatherCurrent() reads the residues on
+        if (fsm.canDeferSequence() && isSequenceLineAhead())
+        {
+            currentDescription = fsm.getDescription();
+            sequencePending = true;
+            return true;
+        }
+
+        stimulateFastaMachine();
+        if (!fsm.keepRunning())
+            return fsm.isValidSequence();
+    }
+}
+
+template<class SequenceType>
+inline void FastaParser<SequenceType>::finishSequence(bool skip)
+{
+    // the residue lines are the only ones left before the machine yields
+    // the record, so nothing read here can throw
+    sequencePending = false;
+    skippingSequence = skip;
+
+    do
+        stimulateFastaMachine();
+    while (fsm.keepRunning());
+
+    skippingSequence = false;
+}
+
+template<class SequenceType>
+inline const std::string& FastaParser<SequenceType>::gatherCurrent()
+{
+    if (sequencePending)
+        finishSequence(false);
+    return currentSequenceString;
+}
+
+template<class SequenceType>
+inline const SequenceType& FastaParser<SequenceType>::decodeCurrent()
+{
+    if (!currentDecoded)
+    {
+        SequenceDecoder<SequenceType>::decode(StringView(gatherCurrent()), currentSequence);
+        currentDecoded = true;
+    }
+    return currentSequence;
+}
+
+template<class SequenceType>
+inline typename FastaParser<SequenceType>::iterator FastaParser<SequenceType>::begin()
+{
+    return iterator(this);
+}
+
+template<class SequenceType>
+inline typename FastaParser<SequenceType>::iterator FastaParser<SequenceType>::end() const
+{
+    return iterator();
+}
+
 template<class SequenceType>
 inline void FastaParser<SequenceType>::reset()
 {
     is.clear();
     is.seekg(0, std::ios::beg);
     fsm.reset();
+    lineNumber = 0;
+    nextLineOffset = 0;
+    recordStart = Position();
+    yieldedStart = Position();
+    sequencePending = false;
+    skippingSequence = false;
 }
 
 }
@@ -25,6 +25,7 @@ fastaSaver.h: load and save sequences(NucSequence, PseudonucSequence, and AminoS
 
 #include <string>
 #include <fstream>
+#include "fastaFormatter.h"
 
 namespace bioppFiler
 {
@@ -39,9 +40,21 @@ public:
     inline void saveNextSequence(const std::string& title, const SequenceType& seq);
     inline void saveNextSequence(const SequenceType& seq);
 
+    /*
+     * Puts back the lower case regions recorded by FastaParser on parsing.
+     */
+    inline void saveNextSequence(const std::string& title, const SequenceType& seq, const SoftMask& mask);
+
+    /*
+     * SequenceTransform flags applied to the sequences saved from now on.
+     */
+    inline void setTransforms(unsigned int transforms, char maskChar = 'N');
+
 private:
 
     std::ofstream os;
+    std::string buffer;
+    SequenceTransform transform;
     static const unsigned int lineLimit = 50;
 
     inline void saveSequence(const SequenceType& seq);
@@ -36,41 +36,46 @@ inline FastaSaver<SequenceType>::FastaSaver(const std::string& file_name)
 template<class SequenceType>
 inline void FastaSaver<SequenceType>::saveNextSequence(const std::string& title, const SequenceType& seq)
 {
+    buffer.clear();
     saveDescription(title);
     saveSequence(seq);
+    os << buffer << std::flush;
 }
 
 template<class SequenceType>
 inline void FastaSaver<SequenceType>::saveNextSequence(const SequenceType& seq)
 {
-    os << std::endl;
+    buffer.clear();
+    FastaFormatter::appendEmptyLine(buffer);
     saveSequence(seq);
+    os << buffer << std::flush;
+}
+
+template<class SequenceType>
+inline void FastaSaver<SequenceType>::saveNextSequence(const std::string& title, const SequenceType& seq, const SoftMask& mask)
+{
+    buffer.clear();
+    saveDescription(title);
+    FastaFormatter::appendSequence(seq.getString(), lineLimit, transform, mask, buffer);
+    os << buffer << std::flush;
+}
+
+template<class SequenceType>
+inline void FastaSaver<SequenceType>::setTransforms(unsigned int transforms, char maskChar)
+{
+    transform = SequenceTransform(transforms, maskChar);
 }
 
 template<class SequenceType>
 inline void FastaSaver<SequenceType>::saveSequence(const SequenceType& seq)
 {
-    const std::string sequence = seq.getString();
-    unsigned int currentCharNumber(0);
-
-    for (size_t i = 0; i < sequence.size(); i++)
-    {
-        os << sequence[i];
-        if (++currentCharNumber == lineLimit)
-        {
-            os << std::endl;
-            currentCharNumber = 0;
-        }
-    }
-
-    if (currentCharNumber != lineLimit)
-        os << std::endl;
+    FastaFormatter::appendSequence(seq.getString(), lineLimit, transform, buffer);
 }
 
 template<class SequenceType>
 inline void FastaSaver<SequenceType>::saveDescription(const std::string& title)
 {
-    os << ">" << title << std::endl;
+    FastaFormatter::appendDescription(title, buffer);
 }
 
 template<class SequenceType>
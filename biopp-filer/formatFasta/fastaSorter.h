@@ -0,0 +1,107 @@
+/*
+fastaSorter.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_SORTER_H
+#define FASTA_SORTER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "fastaParser.h"
+#include "fastaFormatter.h"
+#include "stringView.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Sorts or partitions the records of fasta files bigger than memory.
+ * Records are gathered up to the memory budget, sorted and spilled to
+ * temporary runs, which are then merged k ways. Sorting is stable and
+ * residues are copied verbatim, never converted to SequenceType.
+ */
+template<class SequenceType>
+class FastaSorter
+{
+public:
+
+    /*
+     * Returns the sort (or partition) key of a record; keys compare as strings.
+     */
+    typedef std::string (*KeyFunction)(const std::string& description, const std::string& sequence);
+
+    enum Key
+    {
+        ById,       // first word of the description
+        ByLength    // number of residues
+    };
+
+    inline FastaSorter(size_t memoryBudget, const std::string& tempDirectory = ".");
+
+    inline void sort(const std::string& input, const std::string& output, Key key = ById);
+    inline void sort(const std::string& input, const std::string& output, KeyFunction key);
+
+    /*
+     * Spreads the records among outputs.size() files by the hash of their key;
+     * 'outputs' must not be empty.
+     */
+    inline void partition(const std::string& input, const std::vector<std::string>& outputs, KeyFunction key = idKey);
+
+    static inline std::string idKey(const std::string& description, const std::string& sequence);
+    static inline std::string lengthKey(const std::string& description, const std::string& sequence);
+
+private:
+
+    struct Entry
+    {
+        std::string key;
+        std::string description;
+        std::string sequence;
+
+        bool operator<(const Entry& other) const
+        {
+            return key < other.key;
+        }
+    };
+
+    class Run; // cursor over a sorted run while merging
+
+    static const size_t mergeFanIn = 64;
+    static const unsigned int lineLimit = 50;
+
+    inline const std::string& newRunName(std::vector<std::string>& created);
+    inline void writeEntries(std::vector<Entry>& entries, const std::string& file);
+    inline void merge(const std::vector<std::string>& runs, const std::string& output, KeyFunction key, std::vector<std::string>& created);
+    static inline void removeRuns(const std::vector<std::string>& runs);
+    static inline void openOutput(std::ofstream& os, const std::string& file);
+    static inline void writeRecord(std::ofstream& os, const std::string& description, const std::string& sequence, std::string& buffer);
+    static inline bool later(const Run* a, const Run* b);
+
+    const size_t      memoryBudget;
+    const std::string tempDirectory;
+};
+}
+
+#define FASTA_SORTER_INLINE_H
+#include "fastaSorter_inline.h"
+#undef FASTA_SORTER_INLINE_H
+#endif
@@ -0,0 +1,317 @@
+/*
+fastaSorter_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef FASTA_SORTER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <algorithm>
+#include <queue>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace bioppFiler
+{
+
+template<class SequenceType>
+class FastaSorter<SequenceType>::Run
+{
+public:
+    Run(const std::string& file, size_t number, KeyFunction keyFunction)
+        : parser(file),
+          it(parser.begin()),
+          runNumber(number),
+          key(keyFunction)
+    {
+        load();
+    }
+    bool atEnd() const
+    {
+        return it == parser.end();
+    }
+    void next()
+    {
+        ++it;
+        load();
+    }
+    const Entry& current() const
+    {
+        return entry;
+    }
+    /*
+     * ordering for the merge heap: smallest key first, earlier run on ties
+     */
+    bool operator>(const Run& other) const
+    {
+        return other.entry < entry || (!(entry < other.entry) && runNumber > other.runNumber);
+    }
+private:
+    void load()
+    {
+        if (!atEnd())
+        {
+            entry.description = it->getDescription();
+            entry.sequence = it->getSequenceString();
+            entry.key = key(entry.description, entry.sequence);
+        }
+    }
+    FastaParser<SequenceType> parser;
+    typename FastaParser<SequenceType>::iterator it;
+    const size_t runNumber;
+    const KeyFunction key;
+    Entry entry;
+};
+
+template<class SequenceType>
+inline FastaSorter<SequenceType>::FastaSorter(size_t budget, const std::string& directory)
+    : memoryBudget(budget),
+      tempDirectory(directory)
+{}
+
+template<class SequenceType>
+inline std::string FastaSorter<SequenceType>::idKey(const std::string& description, const std::string&)
+{
+    return RecordFilter::getId(description);
+}
+
+template<class SequenceType>
+inline std::string FastaSorter<SequenceType>::lengthKey(const std::string&, const std::string& sequence)
+{
+    // zero padded, so that the string order is the numeric one
+    std::ostringstream key;
+    key << std::setw(20) << std::setfill('0') << sequence.size();
+    return key.str();
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::sort(const std::string& input, const std::string& output, Key key)
+{
+    sort(input, output, key == ById ? idKey : lengthKey);
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::sort(const std::string& input, const std::string& output, KeyFunction key)
+{
+    FastaParser<SequenceType> parser(input);
+    std::vector<Entry> entries;
+    std::vector<std::string> runs;
+    std::vector<std::string> created; // every run made so far, merged ones included
+    size_t stringBytes = 0;
+
+    try
+    {
+        for (typename FastaParser<SequenceType>::iterator it = parser.begin(); it != parser.end(); ++it)
+        {
+            entries.push_back(Entry());
+            Entry& entry = entries.back();
+            entry.description = it->getDescription();
+            entry.sequence = it->getSequenceString();
+            entry.key = key(entry.description, entry.sequence);
+
+            // what the entries really hold: their strings' buffers and the
+            // whole array, spare capacity included
+            stringBytes += entry.key.capacity() + entry.description.capacity() + entry.sequence.capacity();
+            if (stringBytes + entries.capacity() * sizeof(Entry) >= memoryBudget)
+            {
+                runs.push_back(newRunName(created));
+                writeEntries(entries, runs.back());
+                stringBytes = 0;
+            }
+        }
+
+        if (runs.empty())
+            writeEntries(entries, output);
+        else
+        {
+            if (!entries.empty())
+            {
+                runs.push_back(newRunName(created));
+                writeEntries(entries, runs.back());
+            }
+            merge(runs, output, key, created);
+        }
+    }
+    catch (...)
+    {
+        removeRuns(created);
+        throw;
+    }
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::partition(const std::string& input, const std::vector<std::string>& outputs, KeyFunction key)
+{
+    if (outputs.empty())
+        throw BioppFilerException("FastaSorter, partition needs at least one output");
+
+    std::vector<std::ofstream*> shards(outputs.size());
+    std::string buffer;
+
+    try
+    {
+        for (size_t i = 0; i < outputs.size(); ++i)
+        {
+            shards[i] = new std::ofstream;
+            openOutput(*shards[i], outputs[i]);
+        }
+
+        FastaParser<SequenceType> parser(input);
+        for (typename FastaParser<SequenceType>::iterator it = parser.begin(); it != parser.end(); ++it)
+        {
+            const size_t shard = hashValue(StringView(key(it->getDescription(), it->getSequenceString()))) % shards.size();
+            writeRecord(*shards[shard], it->getDescription(), it->getSequenceString(), buffer);
+        }
+    }
+    catch (...)
+    {
+        for (size_t i = 0; i < shards.size(); ++i)
+            delete shards[i];
+        throw;
+    }
+
+    for (size_t i = 0; i < shards.size(); ++i)
+        delete shards[i];
+}
+
+template<class SequenceType>
+inline const std::string& FastaSorter<SequenceType>::newRunName(std::vector<std::string>& created)
+{
+    // mkstemp creates the file exclusively, so no other sorter, in this
+    // process or another one, can pick the same name
+    const std::string pattern = tempDirectory + "/.biopp-filer-run-XXXXXX";
+    std::vector<char> name(pattern.begin(), pattern.end());
+    name.push_back('\0');
+
+    const int fd = mkstemp(&name[0]);
+    if (fd == -1)
+        throw FileError(pattern);
+    close(fd);
+
+    created.push_back(&name[0]);
+    return created.back();
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::removeRuns(const std::vector<std::string>& runs)
+{
+    for (size_t i = 0; i < runs.size(); ++i)
+        std::remove(runs[i].c_str());
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::writeEntries(std::vector<Entry>& entries, const std::string& file)
+{
+    std::stable_sort(entries.begin(), entries.end());
+
+    std::ofstream os;
+    openOutput(os, file);
+
+    std::string buffer;
+    for (size_t i = 0; i < entries.size(); ++i)
+        writeRecord(os, entries[i].description, entries[i].sequence, buffer);
+
+    entries.clear();
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::merge(const std::vector<std::string>& runs, const std::string& output, KeyFunction key, std::vector<std::string>& created)
+{
+    // too many runs to keep open at once: merge them by groups first
+    if (runs.size() > mergeFanIn)
+    {
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runs.size(); first += mergeFanIn)
+        {
+            const std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(first + mergeFanIn, runs.size()));
+            merged.push_back(newRunName(created));
+            merge(group, merged.back(), key, created);
+        }
+        merge(merged, output, key, created);
+        return;
+    }
+
+    std::ofstream os;
+    openOutput(os, output);
+    std::string buffer;
+
+    std::vector<Run*> cursors;
+    try
+    {
+        typedef std::priority_queue<Run*, std::vector<Run*>, bool (*)(const Run*, const Run*)> Heap;
+        Heap heap(&later);
+
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            cursors.push_back(new Run(runs[i], i, key));
+            if (!cursors.back()->atEnd())
+                heap.push(cursors.back());
+        }
+
+        while (!heap.empty())
+        {
+            Run* const run = heap.top();
+            heap.pop();
+            writeRecord(os, run->current().description, run->current().sequence, buffer);
+            run->next();
+            if (!run->atEnd())
+                heap.push(run);
+        }
+    }
+    catch (...)
+    {
+        for (size_t i = 0; i < cursors.size(); ++i)
+            delete cursors[i];
+        throw;
+    }
+
+    for (size_t i = 0; i < cursors.size(); ++i)
+        delete cursors[i];
+    removeRuns(runs);
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::openOutput(std::ofstream& os, const std::string& file)
+{
+    os.open(file.c_str(), std::ios::out | std::ios::binary);
+    if (!os.is_open())
+        throw FileError(file);
+}
+
+template<class SequenceType>
+inline void FastaSorter<SequenceType>::writeRecord(std::ofstream& os, const std::string& description, const std::string& sequence, std::string& buffer)
+{
+    buffer.clear();
+    FastaFormatter::appendDescription(description, buffer);
+    FastaFormatter::appendSequence(sequence, lineLimit, buffer);
+    os.write(buffer.data(), buffer.size());
+}
+
+template<class SequenceType>
+inline bool FastaSorter<SequenceType>::later(const Run* a, const Run* b)
+{
+    return *a > *b;
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+headerPool.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef HEADER_POOL_H
+#define HEADER_POOL_H
+
+#include <string>
+#include <vector>
+#include "stringView.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Compact storage for description lines. Every line is split at the end of
+ * its ID (first word): IDs are unique per record, so they are kept as they
+ * are. The rest of the line is cut in words, each with the white spaces
+ * before it (" OS=Homo", " sapiens", " PE=1"), and every distinct word is
+ * kept once. A header is stored as its ID followed by the IDs of its words,
+ * varint encoded, so the words seen first and most often take one byte.
+ */
+class HeaderPool
+{
+public:
+
+    typedef unsigned int HeaderId;
+
+    inline HeaderPool();
+
+    inline HeaderId add(const std::string& header);
+
+    /*
+     * The view is valid until the next call to add().
+     */
+    inline StringView getId(HeaderId id) const;
+
+    /*
+     * The words after the ID, without the white spaces leading them.
+     */
+    inline std::string getRest(HeaderId id) const;
+    inline std::string str(HeaderId id) const;
+
+    inline size_t size() const;          // headers added
+    inline size_t distinctWords() const;
+    inline size_t bytes() const;         // memory held, spare capacity included
+    inline void clear();
+
+private:
+
+    typedef unsigned int WordId;
+
+    HeaderPool(const HeaderPool&);
+    HeaderPool& operator=(const HeaderPool&);
+
+    inline StringView getWord(WordId id) const;
+    inline WordId internWord(const char* begin, size_t length);
+    inline void growIndex();
+    inline void appendVarint(unsigned int value);
+    static inline unsigned int readVarint(const char*& position);
+    inline void appendWords(HeaderId id, std::string& out) const;
+
+    std::string               headers;    // varint ID length, ID, varint word IDs
+    std::vector<unsigned int> headerEnds; // size() + 1 entries
+    std::string               words;
+    std::vector<unsigned int> wordEnds;   // distinctWords() + 1 entries
+    std::vector<WordId>       index;      // open addressing: word ID + 1, 0 if free
+};
+}
+
+#define HEADER_POOL_INLINE_H
+#include "headerPool_inline.h"
+#undef HEADER_POOL_INLINE_H
+#endif
@@ -0,0 +1,186 @@
+/*
+headerPool_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef HEADER_POOL_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <algorithm>
+
+namespace bioppFiler
+{
+
+inline HeaderPool::HeaderPool()
+    : headerEnds(1, 0),
+      wordEnds(1, 0),
+      index(64, 0)
+{}
+
+inline StringView HeaderPool::getWord(WordId id) const
+{
+    return StringView(words.data() + wordEnds[id], wordEnds[id + 1] - wordEnds[id]);
+}
+
+inline HeaderPool::WordId HeaderPool::internWord(const char* begin, size_t length)
+{
+    const StringView word(begin, length);
+    const size_t mask = index.size() - 1;
+
+    size_t slot = hashValue(word) & mask;
+    for (; index[slot] != 0; slot = (slot + 1) & mask)
+        if (getWord(index[slot] - 1) == word)
+            return index[slot] - 1;
+
+    const WordId id = static_cast<WordId>(wordEnds.size() - 1);
+    words.append(begin, length);
+    wordEnds.push_back(static_cast<unsigned int>(words.size()));
+    index[slot] = id + 1;
+
+    // kept at most 3/4 full, so that probes stay short
+    if (4 * distinctWords() > 3 * index.size())
+        growIndex();
+
+    return id;
+}
+
+inline void HeaderPool::growIndex()
+{
+    std::vector<WordId> grown(2 * index.size(), 0);
+    const size_t mask = grown.size() - 1;
+
+    for (WordId id = 0; id < distinctWords(); ++id)
+    {
+        size_t slot = hashValue(getWord(id)) & mask;
+        while (grown[slot] != 0)
+            slot = (slot + 1) & mask;
+        grown[slot] = id + 1;
+    }
+
+    index.swap(grown);
+}
+
+inline void HeaderPool::appendVarint(unsigned int value)
+{
+    for (; value >= 0x80; value >>= 7)
+        headers += static_cast<char>((value & 0x7F) | 0x80);
+    headers += static_cast<char>(value);
+}
+
+inline unsigned int HeaderPool::readVarint(const char*& position)
+{
+    unsigned int value = 0;
+    unsigned int shift = 0;
+    unsigned char byte;
+
+    do
+    {
+        byte = static_cast<unsigned char>(*position++);
+        value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+        shift += 7;
+    }
+    while (byte & 0x80);
+
+    return value;
+}
+
+inline HeaderPool::HeaderId HeaderPool::add(const std::string& header)
+{
+    const size_t idLength = std::min(header.find_first_of(" \t"), header.size());
+
+    appendVarint(static_cast<unsigned int>(idLength));
+    headers.append(header, 0, idLength);
+
+    // every word takes the white spaces before it
+    size_t begin = idLength;
+    while (begin < header.size())
+    {
+        size_t end = header.find_first_not_of(" \t", begin);
+        end = (end == std::string::npos) ? header.size() : std::min(header.find_first_of(" \t", end), header.size());
+        appendVarint(internWord(header.data() + begin, end - begin));
+        begin = end;
+    }
+    headerEnds.push_back(static_cast<unsigned int>(headers.size()));
+
+    return static_cast<HeaderId>(size() - 1);
+}
+
+inline StringView HeaderPool::getId(HeaderId id) const
+{
+    const char* position = headers.data() + headerEnds[id];
+    const unsigned int length = readVarint(position);
+    return StringView(position, length);
+}
+
+inline void HeaderPool::appendWords(HeaderId id, std::string& out) const
+{
+    const StringView headerId = getId(id);
+    const char* const end = headers.data() + headerEnds[id + 1];
+
+    for (const char* position = headerId.end(); position != end;)
+    {
+        const StringView word = getWord(readVarint(position));
+        out.append(word.data(), word.size());
+    }
+}
+
+inline std::string HeaderPool::getRest(HeaderId id) const
+{
+    std::string rest;
+    appendWords(id, rest);
+    rest.erase(0, std::min(rest.find_first_not_of(" \t"), rest.size()));
+    return rest;
+}
+
+inline std::string HeaderPool::str(HeaderId id) const
+{
+    std::string header = getId(id).str();
+    appendWords(id, header);
+    return header;
+}
+
+inline size_t HeaderPool::size() const
+{
+    return headerEnds.size() - 1;
+}
+
+inline size_t HeaderPool::distinctWords() const
+{
+    return wordEnds.size() - 1;
+}
+
+inline size_t HeaderPool::bytes() const
+{
+    return headers.capacity() + words.capacity()
+           + (headerEnds.capacity() + wordEnds.capacity()) * sizeof(unsigned int)
+           + index.capacity() * sizeof(WordId);
+}
+
+inline void HeaderPool::clear()
+{
+    headers.clear();
+    headerEnds.assign(1, 0);
+    words.clear();
+    wordEnds.assign(1, 0);
+    index.assign(64, 0);
+}
+
+}
@@ -0,0 +1,149 @@
+/*
+kmerScanner.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef KMER_SCANNER_H
+#define KMER_SCANNER_H
+
+#include <string>
+#include <deque>
+#include <stdint.h>
+#include "stringView.h"
+#include "fastaMachine.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Rolling extraction of k-mers (k <= 32) straight from raw residues, such as
+ * a FastaCollection view or the lines fed by a KmerSink, without building a
+ * SequenceType. Each k-mer is packed 2 bits per base
+ * (A=0, C=1, G=2, T/U=3, either case); any other character (N, IUPAC codes)
+ * breaks the k-mers spanning it.
+ */
+class KmerScanner
+{
+public:
+
+    typedef uint64_t Word;
+
+    inline KmerScanner(unsigned int k, bool canonical = false);
+
+    inline void setSequence(const StringView& residues);
+
+    /*
+     * Continues the sequence with the next piece of residues (i.e. its next
+     * line): k-mers span the pieces and positions keep counting from the
+     * start of the sequence. The previous piece is no longer read.
+     */
+    inline void appendSequence(const StringView& residues);
+
+    /*
+     * position is the offset of the first base of the k-mer
+     */
+    inline bool getNextKmer(Word& kmer, size_t& position);
+
+    inline unsigned int getK() const;
+
+    static inline std::string decode(Word kmer, unsigned int k);
+
+private:
+
+    static inline unsigned char code(char residue);
+
+    const unsigned int k;
+    const bool         canonical;
+    const Word         mask;
+    const unsigned int reverseShift;
+
+    StringView residues;
+    size_t     offset; // position of residues[0] in the sequence
+    size_t     next;
+    unsigned int valid;
+    Word       forward;
+    Word       reverse;
+};
+
+/*
+ * (w, k) minimizers over a KmerScanner: for every window of w consecutive
+ * k-mers the one with the smallest hash, reported once per change.
+ */
+class MinimizerScanner
+{
+public:
+
+    typedef KmerScanner::Word Word;
+
+    inline MinimizerScanner(unsigned int k, unsigned int w, bool canonical = true);
+
+    inline void setSequence(const StringView& residues);
+    inline void appendSequence(const StringView& residues);
+    inline bool getNextMinimizer(Word& minimizer, size_t& position);
+
+    static inline Word hash(Word kmer);
+
+private:
+
+    struct Candidate
+    {
+        Word   hash;
+        Word   kmer;
+        size_t position;
+    };
+
+    KmerScanner           kmers;
+    const unsigned int    w;
+    std::deque<Candidate> window;
+    size_t                lastPosition;
+    size_t                lastReported;
+    unsigned int          inWindow;
+};
+
+/*
+ * Streams the k-mers of the records read by FastaParser::scanNextSequence:
+ * every residue line goes through 'scanner' as soon as it is read, and
+ * visitor(kmer, position) is called for each k-mer, line breaks included,
+ * so the sequence is neither gathered nor scanned twice.
+ */
+template<class Visitor>
+class KmerSink : public FastaMachine::ResidueSink
+{
+public:
+
+    inline KmerSink(KmerScanner& scanner, Visitor visitor);
+
+    inline void beginSequence();
+    inline void appendResidues(const std::string& line);
+
+private:
+
+    KmerScanner& scanner;
+    Visitor      visitor;
+};
+
+template<class Visitor>
+inline KmerSink<Visitor> makeKmerSink(KmerScanner& scanner, Visitor visitor);
+}
+
+#define KMER_SCANNER_INLINE_H
+#include "kmerScanner_inline.h"
+#undef KMER_SCANNER_INLINE_H
+#endif
@@ -0,0 +1,225 @@
+/*
+kmerScanner_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef KMER_SCANNER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+namespace bioppFiler
+{
+
+inline KmerScanner::KmerScanner(unsigned int kmerSize, bool canonicalForm)
+    : k(kmerSize),
+      canonical(canonicalForm),
+      mask(kmerSize >= 32 ? ~Word(0) : (Word(1) << (2 * kmerSize)) - 1),
+      reverseShift(2 * (kmerSize - 1)),
+      offset(0),
+      next(0),
+      valid(0),
+      forward(0),
+      reverse(0)
+{
+    if (k == 0 || k > 32)
+        throw BioppFilerException("KmerScanner, k must be in [1, 32]");
+}
+
+inline unsigned char KmerScanner::code(char residue)
+{
+    // 4 marks a character that breaks k-mers
+    static const struct Table
+    {
+        unsigned char codes[256];
+        Table()
+        {
+            for (unsigned int c = 0; c < 256; ++c)
+                codes[c] = 4;
+            codes['A'] = codes['a'] = 0;
+            codes['C'] = codes['c'] = 1;
+            codes['G'] = codes['g'] = 2;
+            codes['T'] = codes['t'] = 3;
+            codes['U'] = codes['u'] = 3;
+        }
+    } table;
+
+    return table.codes[static_cast<unsigned char>(residue)];
+}
+
+inline void KmerScanner::setSequence(const StringView& sequence)
+{
+    residues = sequence;
+    offset   = 0;
+    next     = 0;
+    valid    = 0;
+    forward  = 0;
+    reverse  = 0;
+}
+
+inline void KmerScanner::appendSequence(const StringView& sequence)
+{
+    offset  += residues.size();
+    residues = sequence;
+    next     = 0;
+}
+
+inline bool KmerScanner::getNextKmer(Word& kmer, size_t& position)
+{
+    while (next < residues.size())
+    {
+        const unsigned char c = code(residues[next++]);
+
+        if (c > 3)
+            valid = 0;
+        else
+        {
+            forward = ((forward << 2) | c) & mask;
+            reverse = (reverse >> 2) | (Word(3 - c) << reverseShift);
+
+            if (valid < k)
+                ++valid;
+
+            if (valid == k)
+            {
+                kmer = (canonical && reverse < forward) ? reverse : forward;
+                position = offset + next - k;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+inline unsigned int KmerScanner::getK() const
+{
+    return k;
+}
+
+inline std::string KmerScanner::decode(Word kmer, unsigned int k)
+{
+    std::string bases(k, 'A');
+    for (unsigned int i = 0; i < k; ++i)
+        bases[k - 1 - i] = "ACGT"[(kmer >> (2 * i)) & 3];
+    return bases;
+}
+
+inline MinimizerScanner::MinimizerScanner(unsigned int k, unsigned int windowSize, bool canonical)
+    : kmers(k, canonical),
+      w(windowSize),
+      lastPosition(0),
+      lastReported(static_cast<size_t>(-1)),
+      inWindow(0)
+{
+    if (w == 0)
+        throw BioppFilerException("MinimizerScanner, w must be positive");
+}
+
+inline MinimizerScanner::Word MinimizerScanner::hash(Word kmer)
+{
+    // invertible 64 bits mix (murmur3 finalizer), avoids poly-A minimizers
+    kmer ^= kmer >> 33;
+    kmer *= 0xff51afd7ed558ccdULL;
+    kmer ^= kmer >> 33;
+    kmer *= 0xc4ceb9fe1a85ec53ULL;
+    kmer ^= kmer >> 33;
+    return kmer;
+}
+
+inline void MinimizerScanner::setSequence(const StringView& residues)
+{
+    kmers.setSequence(residues);
+    window.clear();
+    inWindow = 0;
+    lastReported = static_cast<size_t>(-1);
+}
+
+inline void MinimizerScanner::appendSequence(const StringView& residues)
+{
+    kmers.appendSequence(residues);
+}
+
+inline bool MinimizerScanner::getNextMinimizer(Word& minimizer, size_t& position)
+{
+    Candidate candidate;
+
+    while (kmers.getNextKmer(candidate.kmer, candidate.position))
+    {
+        // a gap (ambiguous residue) starts the windows over
+        if (!window.empty() && candidate.position != lastPosition + 1)
+        {
+            window.clear();
+            inWindow = 0;
+        }
+        lastPosition = candidate.position;
+
+        candidate.hash = hash(candidate.kmer);
+        while (!window.empty() && window.back().hash > candidate.hash)
+            window.pop_back();
+        window.push_back(candidate);
+
+        if (inWindow < w)
+            ++inWindow;
+        while (window.front().position + w <= candidate.position)
+            window.pop_front();
+
+        if (inWindow == w && window.front().position != lastReported)
+        {
+            lastReported = window.front().position;
+            minimizer = window.front().kmer;
+            position = lastReported;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template<class Visitor>
+inline KmerSink<Visitor>::KmerSink(KmerScanner& kmerScanner, Visitor kmerVisitor)
+    : scanner(kmerScanner),
+      visitor(kmerVisitor)
+{}
+
+template<class Visitor>
+inline void KmerSink<Visitor>::beginSequence()
+{
+    scanner.setSequence(StringView());
+}
+
+template<class Visitor>
+inline void KmerSink<Visitor>::appendResidues(const std::string& line)
+{
+    KmerScanner::Word kmer;
+    size_t position;
+
+    scanner.appendSequence(StringView(line));
+    while (scanner.getNextKmer(kmer, position))
+        visitor(kmer, position);
+}
+
+template<class Visitor>
+inline KmerSink<Visitor> makeKmerSink(KmerScanner& scanner, Visitor visitor)
+{
+    return KmerSink<Visitor>(scanner, visitor);
+}
+
+}
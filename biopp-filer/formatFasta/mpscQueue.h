@@ -0,0 +1,67 @@
+/*
+mpscQueue.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+
+namespace bioppFiler
+{
+
+/*
+ * Unbounded lock-free queue for many producers and one consumer
+ * (D. Vyukov's intrusive design). Elements are linked through their own
+ * 'std::atomic<T*> next' member, so pushing allocates nothing; the queue
+ * does not own them. push() is wait-free; pop() must only be called from
+ * the consumer thread, and may transiently miss an element whose push()
+ * has not finished yet.
+ */
+template<class T>
+class MpscQueue
+{
+public:
+
+    inline MpscQueue();
+
+    inline void push(T* element);
+
+    /*
+     * NULL when there is nothing to pop
+     */
+    inline T* pop();
+
+private:
+
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+
+    T               stub; // keeps the list non empty
+    std::atomic<T*> head; // last pushed, shared by producers
+    T*              tail; // consumer side
+};
+}
+
+#define MPSC_QUEUE_INLINE_H
+#include "mpscQueue_inline.h"
+#undef MPSC_QUEUE_INLINE_H
+#endif
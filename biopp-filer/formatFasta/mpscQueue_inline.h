@@ -0,0 +1,83 @@
+/*
+mpscQueue_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef MPSC_QUEUE_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+namespace bioppFiler
+{
+
+template<class T>
+inline MpscQueue<T>::MpscQueue()
+    : head(&stub),
+      tail(&stub)
+{
+    stub.next.store(NULL, std::memory_order_relaxed);
+}
+
+template<class T>
+inline void MpscQueue<T>::push(T* element)
+{
+    element->next.store(NULL, std::memory_order_relaxed);
+    T* const previous = head.exchange(element, std::memory_order_acq_rel);
+    previous->next.store(element, std::memory_order_release);
+}
+
+template<class T>
+inline T* MpscQueue<T>::pop()
+{
+    T* first = tail;
+    T* next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub)
+    {
+        if (next == NULL)
+            return NULL;
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != NULL)
+    {
+        tail = next;
+        return first;
+    }
+
+    // 'first' is the last element: a push may be halfway, or the stub has
+    // to go behind it before it can be handed out
+    if (first != head.load(std::memory_order_acquire))
+        return NULL;
+
+    push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next != NULL)
+    {
+        tail = next;
+        return first;
+    }
+
+    return NULL;
+}
+
+}
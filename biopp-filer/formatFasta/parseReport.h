@@ -0,0 +1,49 @@
+/*
+parseReport.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef PARSE_REPORT_H
+#define PARSE_REPORT_H
+
+#include <string>
+#include <vector>
+
+namespace bioppFiler
+{
+
+/*
+ * Malformed record skipped by a lenient parser.
+ */
+struct ParseError
+{
+    size_t      offset; // byte offset of the offending line
+    size_t      line;   // 1 based line number
+    std::string reason;
+
+    ParseError(size_t off, size_t ln, const std::string& why)
+        : offset(off), line(ln), reason(why)
+    {}
+};
+
+typedef std::vector<ParseError> ParseReport;
+}
+
+#endif
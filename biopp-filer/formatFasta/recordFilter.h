@@ -0,0 +1,77 @@
+/*
+recordFilter.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef RECORD_FILTER_H
+#define RECORD_FILTER_H
+
+#include <string>
+#include <limits>
+#include <regex>
+#include <unordered_set>
+
+namespace bioppFiler
+{
+
+/*
+ * Predicates evaluated by the parser while scanning, so that rejected
+ * records are skipped before their residues are copied or converted.
+ * A record is accepted when its description satisfies every predicate set
+ * and its length lies within [minLength, maxLength].
+ */
+class RecordFilter
+{
+public:
+
+    inline RecordFilter();
+
+    inline void setPrefix(const std::string& prefix);
+    inline void setSubstring(const std::string& substring);
+    inline void setRegex(const std::string& regex);
+    inline void addId(const std::string& id);
+    inline void setLengthBounds(size_t minLength, size_t maxLength = std::numeric_limits<size_t>::max());
+
+    inline bool acceptsDescription(const std::string& description) const;
+    inline bool acceptsLength(size_t length) const;
+    inline size_t getMaxLength() const;
+    inline bool boundsLength() const; // false when any length is accepted
+
+    /*
+     * first word of the description
+     */
+    static inline std::string getId(const std::string& description);
+
+private:
+
+    std::string                     prefix;
+    std::string                     substring;
+    std::regex                      regex;
+    bool                            hasRegex;
+    std::unordered_set<std::string> ids;
+    size_t                          minLength;
+    size_t                          maxLength;
+};
+}
+
+#define RECORD_FILTER_INLINE_H
+#include "recordFilter_inline.h"
+#undef RECORD_FILTER_INLINE_H
+#endif
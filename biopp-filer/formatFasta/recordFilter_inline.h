@@ -0,0 +1,92 @@
+/*
+recordFilter_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef RECORD_FILTER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+namespace bioppFiler
+{
+
+inline RecordFilter::RecordFilter()
+    : hasRegex(false),
+      minLength(0),
+      maxLength(std::numeric_limits<size_t>::max())
+{}
+
+inline void RecordFilter::setPrefix(const std::string& pre)
+{
+    prefix = pre;
+}
+
+inline void RecordFilter::setSubstring(const std::string& sub)
+{
+    substring = sub;
+}
+
+inline void RecordFilter::setRegex(const std::string& expression)
+{
+    regex = std::regex(expression, std::regex::ECMAScript | std::regex::optimize);
+    hasRegex = true;
+}
+
+inline void RecordFilter::addId(const std::string& id)
+{
+    ids.insert(id);
+}
+
+inline void RecordFilter::setLengthBounds(size_t min, size_t max)
+{
+    minLength = min;
+    maxLength = max;
+}
+
+inline std::string RecordFilter::getId(const std::string& description)
+{
+    return description.substr(0, description.find_first_of(" \t"));
+}
+
+inline bool RecordFilter::acceptsDescription(const std::string& description) const
+{
+    // cheapest predicates first
+    return description.compare(0, prefix.size(), prefix) == 0
+           && (ids.empty() || ids.count(getId(description)) != 0)
+           && (substring.empty() || description.find(substring) != std::string::npos)
+           && (!hasRegex || std::regex_search(description, regex));
+}
+
+inline bool RecordFilter::acceptsLength(size_t length) const
+{
+    return minLength <= length && length <= maxLength;
+}
+
+inline size_t RecordFilter::getMaxLength() const
+{
+    return maxLength;
+}
+
+inline bool RecordFilter::boundsLength() const
+{
+    return minLength != 0 || maxLength != std::numeric_limits<size_t>::max();
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+sequenceDecoder.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SEQUENCE_DECODER_H
+#define SEQUENCE_DECODER_H
+
+#include <string>
+#include "stringView.h"
+
+namespace bioppFiler
+{
+
+/*
+ * Builds a SequenceType from raw residues, read in place from a parser's
+ * scan buffer or a collection. The default goes through the string
+ * constructor; specialize it to plug in a direct conversion for a given
+ * sequence type (see bioppDecoder.h). Specializations provide both calls.
+ */
+template<class SequenceType>
+struct SequenceDecoder
+{
+    /*
+     * Throws when 'raw' does not convert.
+     */
+    static inline void decode(const StringView& raw, SequenceType& sequence);
+
+    /*
+     * Returns false, and the reason in 'error', when 'raw' does not convert;
+     * this is what lenient parsing uses. The default can only catch what the
+     * string constructor throws; a specialization should validate instead.
+     */
+    static inline bool tryDecode(const StringView& raw, SequenceType& sequence, std::string& error);
+};
+}
+
+#define SEQUENCE_DECODER_INLINE_H
+#include "sequenceDecoder_inline.h"
+#undef SEQUENCE_DECODER_INLINE_H
+#endif
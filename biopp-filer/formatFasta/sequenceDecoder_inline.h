@@ -0,0 +1,57 @@
+/*
+sequenceDecoder_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SEQUENCE_DECODER_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <exception>
+
+namespace bioppFiler
+{
+
+template<class SequenceType>
+inline void SequenceDecoder<SequenceType>::decode(const StringView& raw, SequenceType& sequence)
+{
+    sequence = SequenceType(raw.str());
+}
+
+template<class SequenceType>
+inline bool SequenceDecoder<SequenceType>::tryDecode(const StringView& raw, SequenceType& sequence, std::string& error)
+{
+    try
+    {
+        decode(raw, sequence);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = "Invalid sequence";
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,136 @@
+/*
+sequenceTransform.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SEQUENCE_TRANSFORM_H
+#define SEQUENCE_TRANSFORM_H
+
+#include <string>
+#include <cstddef>
+#include "softMask.h"
+
+/*
+ * The SSSE3 lookups are built whenever the compiler can target them, and
+ * picked at run time on the CPUs that have the instructions.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BIOPP_FILER_SSSE3 1
+#include <tmmintrin.h>
+#define BIOPP_FILER_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+namespace bioppFiler
+{
+
+/*
+ * Residue rewrites applied by the savers while they wrap lines, so that no
+ * transformed copy of the sequence is ever built. Every per residue
+ * transform is folded into a single 256 entries table, applied in this
+ * order: complement, T/U swap, masking, case.
+ */
+class SequenceTransform
+{
+public:
+
+    enum Transform
+    {
+        None              = 0,
+        ReverseComplement = 1 << 0,
+        UToT              = 1 << 1,
+        TToU              = 1 << 2,
+        Mask              = 1 << 3, // lower case (soft masked) residues become maskChar
+        UpperCase         = 1 << 4,
+        LowerCase         = 1 << 5
+    };
+
+    /*
+     * Throws BioppFilerException if both UToT and TToU, or both UpperCase
+     * and LowerCase, are asked for.
+     */
+    inline SequenceTransform(unsigned int transforms = None, char maskChar = 'N');
+
+    inline bool isIdentity() const;
+    inline bool isReverse() const;
+
+    /*
+     * Appends seq[from, from + length) transformed; with ReverseComplement
+     * that range is counted from the end of seq.
+     */
+    inline void apply(const std::string& seq, size_t from, size_t length, std::string& out) const;
+
+    /*
+     * Same, with the residues under 'mask' (positions of seq) handled as
+     * lower case ones: they are hard masked with Mask, kept upper case with
+     * UpperCase, and written in lower case otherwise.
+     */
+    inline void apply(const std::string& seq, size_t from, size_t length, const SoftMask& mask, std::string& out) const;
+
+    /*
+     * true when this CPU runs the 16 residues lookups
+     */
+    static inline bool usesSsse3();
+
+private:
+
+    static inline char complement(char residue);
+
+    /*
+     * dst[i] = table[src[i]] for i in [0, length); the reverse flavour
+     * walks src backwards from its last residue. With SSSE3 they look up
+     * 16 residues at a time, for blocks made only of letters (0x40-0x7F).
+     */
+    static inline void translate(const char* table, const char* src, size_t length, char* dst);
+    static inline void translateReverse(const char* table, const char* last, size_t length, char* dst);
+
+#if defined(BIOPP_FILER_SSSE3)
+    /*
+     * The SSSE3 part of the above: translates the whole 16 residues blocks,
+     * and returns how many residues that was.
+     */
+    static inline BIOPP_FILER_TARGET_SSSE3 size_t translateBlocks(const char* table, const char* src, size_t length, char* dst);
+    static inline BIOPP_FILER_TARGET_SSSE3 size_t translateReverseBlocks(const char* table, const char* last, size_t length, char* dst);
+
+    /*
+     * Looks up 16 residues in the letters part of 'table'. Returns false,
+     * leaving 'out' untouched, if any of them is not in 0x40-0x7F.
+     */
+    static inline BIOPP_FILER_TARGET_SSSE3 bool lookupLetters(const char* table, __m128i residues, __m128i& out);
+#endif
+
+    /*
+     * Writes seq[begin, end) through 'residues' into dst, which holds the
+     * output of residues [low, high).
+     */
+    inline void translateRange(const char* residues, const std::string& seq, size_t begin, size_t end, size_t low, size_t high, char* dst) const;
+
+    static inline bool endsAfter(size_t position, const SoftMask::Interval& interval);
+
+    char table[256];
+    char maskedTable[256]; // table[tolower(c)]: soft masked residues
+    bool reverse;
+    bool identity;
+};
+}
+
+#define SEQUENCE_TRANSFORM_INLINE_H
+#include "sequenceTransform_inline.h"
+#undef SEQUENCE_TRANSFORM_INLINE_H
+#endif
@@ -0,0 +1,233 @@
+/*
+sequenceTransform_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SEQUENCE_TRANSFORM_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <cctype>
+#include <cstddef>
+#include <algorithm>
+
+namespace bioppFiler
+{
+
+inline SequenceTransform::SequenceTransform(unsigned int transforms, char maskChar)
+    : reverse((transforms & ReverseComplement) != 0),
+      identity(transforms == None)
+{
+    if ((transforms & UToT) && (transforms & TToU))
+        throw BioppFilerException("SequenceTransform, UToT and TToU exclude each other");
+    if ((transforms & UpperCase) && (transforms & LowerCase))
+        throw BioppFilerException("SequenceTransform, UpperCase and LowerCase exclude each other");
+
+    for (unsigned int i = 0; i < 256; ++i)
+    {
+        char c = static_cast<char>(i);
+
+        if (transforms & ReverseComplement)
+            c = complement(c);
+
+        if ((transforms & UToT) && (c == 'U' || c == 'u'))
+            c = (c == 'U') ? 'T' : 't';
+        if ((transforms & TToU) && (c == 'T' || c == 't'))
+            c = (c == 'T') ? 'U' : 'u';
+
+        if ((transforms & Mask) && std::islower(static_cast<unsigned char>(c)))
+            c = maskChar;
+
+        if (transforms & UpperCase)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (transforms & LowerCase)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+        table[i] = c;
+    }
+
+    for (unsigned int i = 0; i < 256; ++i)
+        maskedTable[i] = table[static_cast<unsigned char>(std::tolower(static_cast<int>(i)))];
+}
+
+inline char SequenceTransform::complement(char residue)
+{
+    // IUPAC complements, case preserved; T and U both pair with A
+    static const char from[] = "ACGTURYKMBVDHSWNacgturykmbvdhswn";
+    static const char to[]   = "TGCAAYRMKVBHDSWNtgcaayrmkvbhdswn";
+
+    for (unsigned int i = 0; from[i] != '\0'; ++i)
+        if (from[i] == residue)
+            return to[i];
+
+    return residue;
+}
+
+inline bool SequenceTransform::isIdentity() const
+{
+    return identity;
+}
+
+inline bool SequenceTransform::isReverse() const
+{
+    return reverse;
+}
+
+inline bool SequenceTransform::usesSsse3()
+{
+#if defined(BIOPP_FILER_SSSE3)
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3") != 0);
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#if defined(BIOPP_FILER_SSSE3)
+inline bool SequenceTransform::lookupLetters(const char* table, __m128i residues, __m128i& out)
+{
+    const __m128i highBits = _mm_and_si128(residues, _mm_set1_epi8(static_cast<char>(0xC0)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(highBits, _mm_set1_epi8(0x40))) != 0xFFFF)
+        return false;
+
+    // one 16 entries row per value of bits 4 and 5; pshufb takes the low nibble
+    const __m128i row0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 0x40)), residues);
+    const __m128i row1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 0x50)), residues);
+    const __m128i row2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 0x60)), residues);
+    const __m128i row3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 0x70)), residues);
+
+    const __m128i bit4 = _mm_cmpeq_epi8(_mm_and_si128(residues, _mm_set1_epi8(0x10)), _mm_set1_epi8(0x10));
+    const __m128i bit5 = _mm_cmpeq_epi8(_mm_and_si128(residues, _mm_set1_epi8(0x20)), _mm_set1_epi8(0x20));
+    const __m128i upper = _mm_or_si128(_mm_andnot_si128(bit4, row0), _mm_and_si128(bit4, row1));
+    const __m128i lower = _mm_or_si128(_mm_andnot_si128(bit4, row2), _mm_and_si128(bit4, row3));
+    out = _mm_or_si128(_mm_andnot_si128(bit5, upper), _mm_and_si128(bit5, lower));
+    return true;
+}
+
+inline size_t SequenceTransform::translateBlocks(const char* table, const char* src, size_t length, char* dst)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block;
+        if (lookupLetters(table, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), block))
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), block);
+        else
+            for (size_t j = i; j < i + 16; ++j)
+                dst[j] = table[static_cast<unsigned char>(src[j])];
+    }
+    return i;
+}
+
+inline size_t SequenceTransform::translateReverseBlocks(const char* table, const char* last, size_t length, char* dst)
+{
+    const __m128i reversed = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i residues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last - i - 15));
+        __m128i block;
+        if (lookupLetters(table, _mm_shuffle_epi8(residues, reversed), block))
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), block);
+        else
+            for (size_t j = i; j < i + 16; ++j)
+                dst[j] = table[static_cast<unsigned char>(*(last - j))];
+    }
+    return i;
+}
+#endif
+
+inline void SequenceTransform::translate(const char* table, const char* src, size_t length, char* dst)
+{
+    size_t i = 0;
+#if defined(BIOPP_FILER_SSSE3)
+    if (usesSsse3())
+        i = translateBlocks(table, src, length, dst);
+#endif
+    for (; i < length; ++i)
+        dst[i] = table[static_cast<unsigned char>(src[i])];
+}
+
+inline void SequenceTransform::translateReverse(const char* table, const char* last, size_t length, char* dst)
+{
+    size_t i = 0;
+#if defined(BIOPP_FILER_SSSE3)
+    if (usesSsse3())
+        i = translateReverseBlocks(table, last, length, dst);
+#endif
+    for (; i < length; ++i)
+        dst[i] = table[static_cast<unsigned char>(*(last - i))];
+}
+
+inline void SequenceTransform::apply(const std::string& seq, size_t from, size_t length, std::string& out) const
+{
+    const size_t start = out.size();
+    out.resize(start + length);
+    char* const dst = &out[start];
+
+    if (reverse)
+        translateReverse(table, seq.data() + seq.size() - from - 1, length, dst);
+    else
+        translate(table, seq.data() + from, length, dst);
+}
+
+
+inline void SequenceTransform::apply(const std::string& seq, size_t from, size_t length, const SoftMask& mask, std::string& out) const
+{
+    const size_t start = out.size();
+    out.resize(start + length);
+    char* const dst = &out[start];
+
+    // residues [low, high) of seq are the ones written, whatever the direction
+    const size_t low = reverse ? seq.size() - from - length : from;
+    const size_t high = low + length;
+
+    const SoftMask::Intervals& intervals = mask.getIntervals();
+    SoftMask::Intervals::const_iterator it = std::upper_bound(intervals.begin(), intervals.end(), low, endsAfter);
+    size_t position = low;
+
+    for (; it != intervals.end() && it->begin < high; ++it)
+    {
+        const size_t maskBegin = std::max(it->begin, low);
+        const size_t maskEnd = std::min(it->end, high);
+        translateRange(table, seq, position, maskBegin, low, high, dst);
+        translateRange(maskedTable, seq, maskBegin, maskEnd, low, high, dst);
+        position = maskEnd;
+    }
+    translateRange(table, seq, position, high, low, high, dst);
+}
+
+inline void SequenceTransform::translateRange(const char* residues, const std::string& seq, size_t begin, size_t end, size_t low, size_t high, char* dst) const
+{
+    if (begin >= end)
+        return;
+
+    if (reverse)
+        translateReverse(residues, seq.data() + end - 1, end - begin, dst + (high - end));
+    else
+        translate(residues, seq.data() + begin, end - begin, dst + (begin - low));
+}
+
+inline bool SequenceTransform::endsAfter(size_t position, const SoftMask::Interval& interval)
+{
+    return position < interval.end;
+}
+
+}
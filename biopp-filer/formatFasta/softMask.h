@@ -0,0 +1,81 @@
+/*
+softMask.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SOFT_MASK_H
+#define SOFT_MASK_H
+
+#include <string>
+#include <vector>
+
+namespace bioppFiler
+{
+
+/*
+ * Lower case (soft masked) regions of a sequence kept as sorted, disjoint,
+ * half open intervals of residue positions, so that the sequence itself can
+ * be stored in a single case.
+ */
+class SoftMask
+{
+public:
+
+    struct Interval
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    typedef std::vector<Interval> Intervals;
+
+    inline void clear();
+    inline bool empty() const;
+    inline size_t size() const;
+    inline const Interval& operator[](size_t i) const;
+    inline const Intervals& getIntervals() const;
+
+    /*
+     * Intervals must be added in increasing order; adjacent ones are merged.
+     */
+    inline void add(size_t begin, size_t end);
+    inline size_t maskedLength() const;
+
+    /*
+     * Replaces the intervals by the lower case runs of residues, and turns
+     * those runs to upper case.
+     */
+    inline void extract(std::string& residues);
+
+    /*
+     * Turns the masked residues back to lower case.
+     */
+    inline void restore(std::string& residues) const;
+
+private:
+
+    Intervals intervals;
+};
+}
+
+#define SOFT_MASK_INLINE_H
+#include "softMask_inline.h"
+#undef SOFT_MASK_INLINE_H
+#endif
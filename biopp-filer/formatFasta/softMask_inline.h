@@ -0,0 +1,109 @@
+/*
+softMask_inline.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef SOFT_MASK_INLINE_H
+#error Internal header file, DO NOT include this.
+#endif
+
+#include <cctype>
+
+namespace bioppFiler
+{
+
+inline void SoftMask::clear()
+{
+    intervals.clear();
+}
+
+inline bool SoftMask::empty() const
+{
+    return intervals.empty();
+}
+
+inline size_t SoftMask::size() const
+{
+    return intervals.size();
+}
+
+inline const SoftMask::Interval& SoftMask::operator[](size_t i) const
+{
+    return intervals[i];
+}
+
+inline const SoftMask::Intervals& SoftMask::getIntervals() const
+{
+    return intervals;
+}
+
+inline void SoftMask::add(size_t begin, size_t end)
+{
+    if (begin >= end)
+        return;
+
+    if (!intervals.empty() && intervals.back().end == begin)
+        intervals.back().end = end;
+    else
+    {
+        const Interval interval = {begin, end};
+        intervals.push_back(interval);
+    }
+}
+
+inline size_t SoftMask::maskedLength() const
+{
+    size_t length = 0;
+    for (Intervals::const_iterator it = intervals.begin(); it != intervals.end(); ++it)
+        length += it->end - it->begin;
+    return length;
+}
+
+inline void SoftMask::extract(std::string& residues)
+{
+    intervals.clear();
+
+    size_t i = 0;
+    while (i < residues.size())
+    {
+        if (std::islower(static_cast<unsigned char>(residues[i])))
+        {
+            const size_t begin = i;
+            do
+            {
+                residues[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(residues[i])));
+                ++i;
+            }
+            while (i < residues.size() && std::islower(static_cast<unsigned char>(residues[i])));
+            add(begin, i);
+        }
+        else
+            ++i;
+    }
+}
+
+inline void SoftMask::restore(std::string& residues) const
+{
+    for (Intervals::const_iterator it = intervals.begin(); it != intervals.end(); ++it)
+        for (size_t i = it->begin; i < it->end && i < residues.size(); ++i)
+            residues[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(residues[i])));
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+stringView.h: load and save sequences(NucSequence, PseudonucSequence, and AminoSequence)
+    Copyright (C) 2012 Facundo Muñoz FuDePAN
+
+    This file is part of Biopp-filer.
+
+    Biopp-filer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biopp-filer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Biopp-filer.  If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE: This file is in prototype stage, and is under active development.
+*/
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include <string>
+#include <cstring>
+#include <ostream>
+
+namespace bioppFiler
+{
+
+/*
+ * Non owning reference to a range of characters stored elsewhere
+ * (i.e. inside a FastaCollection). It is only valid while its owner lives.
+ */
+class StringView
+{
+public:
+
+    typedef const char* const_iterator;
+    typedef size_t      size_type;
+
+    StringView()
+        : first(NULL), length(0)
+    {}
+
+    StringView(const char* data, size_type size)
+        : first(data), length(size)
+    {}
+
+    explicit StringView(const std::string& str)
+        : first(str.data()), length(str.size())
+    {}
+
+    const char* data() const
+    {
+        return first;
+    }
+
+    size_type size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return first;
+    }
+
+    const_iterator end() const
+    {
+        return first + length;
+    }
+
+    char operator[](size_type i) const
+    {
+        return first[i];
+    }
+
+    std::string str() const
+    {
+        return std::string(first, length);
+    }
+
+    bool operator==(const StringView& other) const
+    {
+        return length == other.length && (length == 0 || std::memcmp(first, other.first, length) == 0);
+    }
+
+    bool operator!=(const StringView& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+
+    const char* first;
+    size_type   length;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const StringView& view)
+{
+    return os.write(view.data(), view.size());
+}
+
+/*
+ * FNV-1a hash of the characters
+ */
+inline size_t hashValue(const StringView& view)
+{
+    size_t hash = 2166136261u;
+    for (StringView::const_iterator it = view.begin(); it != view.end(); ++it)
+        hash = (hash ^ static_cast<unsigned char>(*it)) * 16777619u;
+    return hash;
+}
+}
+
+#endif
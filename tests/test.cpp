@@ -1,9 +1,22 @@
 #include <string>
 #include <list>
+#include <vector>
+#include <set>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
 #include <iostream>
 #include <gtest/gtest.h>
 #include <biopp/biopp.h>
+#include <dirent.h>
 #include "biopp-filer/bioppFiler.h"
+#include "biopp-filer/formatFasta/bioppDecoder.h"
 
 using namespace bioppFiler;
 
@@ -196,3 +209,878 @@ TEST(FastaFormatTest, Load)
     ASSERT_EQ("AUUG", seq3.getString());
     ASSERT_EQ("", title3);
 }
+
+TEST(FastaCollectionTest, ParallelLoad)
+{
+    const std::string file("ParallelLoad.txt");
+
+    std::ofstream of(file.c_str());
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+        of << ">sequence_" << i << " ;comentario\n";
+        for (unsigned int j = 0; j <= i % 7; ++j)
+            of << "ATCGAATCGA\n";
+        if (i % 5 == 0)
+            of << "\nGGCCT\n";
+    }
+    of.close();
+
+    std::vector<biopp::NucSequence> sequences;
+    std::vector<std::string> descriptions;
+
+    FastaParser<biopp::NucSequence> fp(file);
+    biopp::NucSequence sequenceLoad;
+    std::string titleLoad;
+    while (fp.getNextSequence(titleLoad, sequenceLoad))
+    {
+        sequences.push_back(sequenceLoad);
+        descriptions.push_back(titleLoad);
+    }
+
+    const FastaCollection<biopp::NucSequence> sequential(file, 1);
+    const FastaCollection<biopp::NucSequence> parallel(file, 8);
+
+    ASSERT_EQ(sequences.size(), sequential.size());
+    ASSERT_EQ(sequences.size(), parallel.size());
+
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        ASSERT_EQ(sequences[i], parallel.getSequence(i));
+        ASSERT_EQ(descriptions[i], parallel.getDescription(i).str());
+        ASSERT_EQ(sequential.getSequenceView(i), parallel.getSequenceView(i));
+    }
+}
+
+TEST(ConcurrentFastaSaverTest, OrderedAndUnordered)
+{
+    const std::string orderedFile("ConcurrentOrdered.txt");
+    const std::string unorderedFile("ConcurrentUnordered.txt");
+    const unsigned int threads = 8;
+    const unsigned int perThread = 100;
+    const biopp::NucSequence sequence("ATCGAATCGATCGTCGATCGAATCGATCGTCGATCGAATCGATCGTCGATCGAATCGATCGTCG");
+
+    {
+        ConcurrentFastaSaver<biopp::NucSequence> ordered(orderedFile, ConcurrentFastaSaver<biopp::NucSequence>::Ordered);
+        ConcurrentFastaSaver<biopp::NucSequence> unordered(unorderedFile);
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; ++t)
+        {
+            workers.push_back(std::thread([&, t]()
+            {
+                for (unsigned int i = 0; i < perThread; ++i)
+                {
+                    const unsigned int number = i * threads + t;
+                    std::ostringstream title;
+                    title << "sequence " << number;
+                    ordered.saveNextSequence(number, title.str(), sequence);
+                    unordered.saveNextSequence(title.str(), sequence);
+                }
+            }));
+        }
+        for (unsigned int t = 0; t < threads; ++t)
+            workers[t].join();
+
+        unordered.close();
+        ASSERT_THROW(unordered.saveNextSequence("late", sequence), BioppFilerException);
+    }
+
+    biopp::NucSequence sequenceLoad;
+    std::string titleLoad;
+    unsigned int count = 0;
+
+    FastaParser<biopp::NucSequence> orderedParser(orderedFile);
+    while (orderedParser.getNextSequence(titleLoad, sequenceLoad))
+    {
+        std::ostringstream title;
+        title << "sequence " << count++;
+        ASSERT_EQ(title.str(), titleLoad);
+        ASSERT_EQ(sequence, sequenceLoad);
+    }
+    ASSERT_EQ(threads * perThread, count);
+
+    std::set<std::string> titles;
+    FastaParser<biopp::NucSequence> unorderedParser(unorderedFile);
+    while (unorderedParser.getNextSequence(titleLoad, sequenceLoad))
+    {
+        titles.insert(titleLoad);
+        ASSERT_EQ(sequence, sequenceLoad);
+    }
+    ASSERT_EQ(threads * perThread, titles.size());
+}
+
+static bool isLongRecord(const FastaParser<biopp::NucSequence>::Record& record)
+{
+    return record.length() > 4;
+}
+
+TEST(FastaFormatTest, Iterators)
+{
+    const std::string file("Iterators.txt");
+
+    std::ofstream of(file.c_str());
+    of << ">SEQUENCE_1\nATCGA\nTCG\n>sequence_2\nAGG\n>sequence_3\nAGGTGA\n";
+    of.close();
+
+    FastaParser<biopp::NucSequence> fp(file);
+
+    std::list<std::string> titles;
+    for (FastaParser<biopp::NucSequence>::iterator it = fp.begin(); it != fp.end(); ++it)
+        titles.push_back(it->getDescription());
+
+    ASSERT_EQ(3u, titles.size());
+    ASSERT_EQ("SEQUENCE_1", titles.front());
+    ASSERT_EQ("sequence_3", titles.back());
+
+    fp.reset();
+    ASSERT_EQ(2, std::count_if(fp.begin(), fp.end(), isLongRecord));
+
+    fp.reset();
+    FastaParser<biopp::NucSequence>::iterator it = fp.begin();
+    ++it;
+    ASSERT_EQ("sequence_2", it->getDescription());
+    ASSERT_EQ("AGG", it->getSequence().getString());
+
+    // the residues of the records never read are skipped, and the parser
+    // goes on after them
+    fp.reset();
+    it = fp.begin();
+    ASSERT_EQ("SEQUENCE_1", it->getDescription());
+    ++it;
+    ++it;
+    ASSERT_EQ("sequence_3", it->getDescription());
+    ASSERT_EQ(6u, it->length());
+    ASSERT_EQ("AGGUGA", it->getSequence().getString());
+    ASSERT_TRUE(++it == fp.end());
+
+    fp.reset();
+    it = fp.begin();
+    std::string title;
+    biopp::NucSequence sequence;
+    ASSERT_TRUE(fp.getNextSequence(title, sequence));
+    ASSERT_EQ("sequence_2", title);
+    ASSERT_EQ("AGG", sequence.getString());
+
+#if __cplusplus >= 202002L
+    fp.reset();
+    std::list<std::string> longSequences;
+    const auto toString = [](const FastaParser<biopp::NucSequence>::Record & record)
+    {
+        return record.getSequence().getString();
+    };
+    for (const std::string& seq : fp | std::views::filter(isLongRecord) | std::views::transform(toString))
+        longSequences.push_back(seq);
+
+    ASSERT_EQ(2u, longSequences.size());
+    ASSERT_EQ("AUCGAUCG", longSequences.front());
+    ASSERT_EQ("AGGUGA", longSequences.back());
+#endif
+}
+
+TEST(FastaFormatTest, InternedHeaders)
+{
+    const std::string file("InternedHeaders.txt");
+
+    std::ofstream of(file.c_str());
+    of << ">P1 Kinase OS=Homo sapiens\nACG\n>P2\tKinase\nACG\n>P1 Kinase  OS=Homo sapiens\nGGT\n>P3\nCCA\n";
+    of.close();
+
+    HeaderPool pool;
+    FastaParser<biopp::NucSequence> fp(file);
+
+    std::vector<HeaderPool::HeaderId> headers;
+    HeaderPool::HeaderId header;
+    biopp::NucSequence sequence;
+    while (fp.getNextSequence(header, sequence, pool))
+        headers.push_back(header);
+
+    ASSERT_EQ(4u, sizeof(HeaderPool::HeaderId));
+    ASSERT_EQ(4u, headers.size());
+    ASSERT_EQ(4u, pool.size());
+    // " Kinase", " OS=Homo", " sapiens", "\tKinase", "  OS=Homo"
+    ASSERT_EQ(5u, pool.distinctWords());
+
+    ASSERT_EQ("P1 Kinase OS=Homo sapiens", pool.str(headers[0]));
+    ASSERT_EQ("P1", pool.getId(headers[0]).str());
+    ASSERT_EQ("Kinase OS=Homo sapiens", pool.getRest(headers[0]));
+    ASSERT_EQ("P2\tKinase", pool.str(headers[1]));
+    ASSERT_EQ("Kinase", pool.getRest(headers[1]));
+    ASSERT_EQ("P1 Kinase  OS=Homo sapiens", pool.str(headers[2]));
+    ASSERT_EQ("P3", pool.str(headers[3]));
+    ASSERT_TRUE(pool.getRest(headers[3]).empty());
+}
+
+TEST(FastaFormatTest, InternedHeadersFootprint)
+{
+    const std::string file("InternedHeadersFootprint.txt");
+    const char* const names[] = {"Serine/threonine-protein kinase", "Tyrosine-protein kinase", "Zinc finger protein", "Uncharacterized protein"};
+    const char* const organisms[] = {"Homo sapiens OX=9606", "Mus musculus OX=10090", "Rattus norvegicus OX=10116"};
+    const unsigned int records = 5000;
+
+    // UniProt like: repetitive, but no two headers share the whole rest
+    std::vector<std::string> lines;
+    std::ofstream of(file.c_str());
+    for (unsigned int i = 0; i < records; ++i)
+    {
+        std::ostringstream line;
+        line << "sp|Q" << std::setw(5) << std::setfill('0') << i << "|KS" << i << "_HUMAN " << names[i % 4] << " " << i % 97
+             << " OS=" << organisms[i % 3] << " GN=KS" << i << " PE=" << 1 + i % 3 << " SV=" << 1 + i % 2;
+        lines.push_back(line.str());
+        of << ">" << lines.back() << "\nACGT\n";
+    }
+    of.close();
+
+    HeaderPool pool;
+    FastaParser<biopp::NucSequence> fp(file);
+
+    std::vector<HeaderPool::HeaderId> headers;
+    HeaderPool::HeaderId header;
+    biopp::NucSequence sequence;
+    size_t stringBytes = 0;
+    while (fp.getNextSequence(header, sequence, pool))
+    {
+        headers.push_back(header);
+        stringBytes += sizeof(std::string) + lines[header].capacity();
+    }
+
+    ASSERT_EQ(records, pool.size());
+    for (unsigned int i = 0; i < records; i += 499)
+        ASSERT_EQ(lines[i], pool.str(headers[i]));
+
+    // handles included, less than half the memory of one string per header
+    // only the GN= words are unique to a header
+    ASSERT_LT(pool.distinctWords(), records + 200u);
+    // handles and spare capacity included, well below one string per header
+    ASSERT_LT(pool.bytes() + headers.size() * sizeof(HeaderPool::HeaderId), stringBytes * 3 / 4);
+}
+
+TEST(FastaFormatTest, LenientParsing)
+{
+    const std::string file("LenientParsing.txt");
+
+    std::ofstream of(file.c_str());
+    of << ">broken_1\n>sequence_1\nATCG\n>broken_2\n\nGGGG\n>sequence_2\nAGGT\n>broken_3\n";
+    of.close();
+
+    FastaParser<biopp::NucSequence> strict(file);
+    std::string title;
+    biopp::NucSequence sequence;
+    ASSERT_THROW(strict.getNextSequence(title, sequence), FileError);
+
+    ParseReport report;
+    FastaParser<biopp::NucSequence> lenient(file, report);
+
+    std::list<std::string> titles;
+    std::list<biopp::NucSequence> sequences;
+    while (lenient.getNextSequence(title, sequence))
+    {
+        titles.push_back(title);
+        sequences.push_back(sequence);
+    }
+
+    ASSERT_EQ(2u, titles.size());
+    ASSERT_EQ("sequence_1", titles.front());
+    ASSERT_EQ("sequence_2", titles.back());
+    ASSERT_EQ("AGGU", sequences.back().getString());
+
+    // every entry points at the description line of the dropped record
+    ASSERT_EQ(3u, report.size());
+    ASSERT_EQ(1u, report[0].line);
+    ASSERT_EQ(0u, report[0].offset);
+    ASSERT_EQ(4u, report[1].line);
+    ASSERT_EQ(27u, report[1].offset);
+    ASSERT_EQ(9u, report[2].line);
+    ASSERT_EQ(60u, report[2].offset);
+
+    of.open(file.c_str());
+    of << ">ok\nACGT\n>broken\n>ok2\nAC\n>tail\n";
+    of.close();
+
+    ParseReport tailReport;
+    FastaParser<biopp::NucSequence> tailParser(file, tailReport);
+    while (tailParser.getNextSequence(title, sequence))
+    {}
+    ASSERT_EQ(2u, tailReport.size());
+    ASSERT_EQ(3u, tailReport[0].line);
+    ASSERT_EQ(9u, tailReport[0].offset);
+    ASSERT_EQ(6u, tailReport[1].line);
+    ASSERT_EQ(25u, tailReport[1].offset);
+
+    of.open(file.c_str());
+    of << ">bad\nACXT\n>ok\nACGT";
+    of.close();
+
+    ParseReport residueReport;
+    FastaParser<biopp::NucSequence> residueParser(file, residueReport);
+    ASSERT_TRUE(residueParser.getNextSequence(title, sequence));
+    ASSERT_EQ("ok", title);
+    ASSERT_EQ("ACGU", sequence.getString());
+    ASSERT_FALSE(residueParser.getNextSequence(title, sequence));
+    ASSERT_EQ(1u, residueReport.size());
+    ASSERT_EQ(1u, residueReport[0].line);
+    ASSERT_EQ(0u, residueReport[0].offset);
+
+    // the iterator skips and reports the same records, and its Records
+    // never throw
+    ParseReport iteratorReport;
+    FastaParser<biopp::NucSequence> iteratorParser(file, iteratorReport);
+    FastaParser<biopp::NucSequence>::iterator it = iteratorParser.begin();
+    ASSERT_TRUE(it != iteratorParser.end());
+    ASSERT_EQ("ok", it->getDescription());
+    ASSERT_EQ("ACGU", it->getSequence().getString());
+    ASSERT_TRUE(++it == iteratorParser.end());
+    ASSERT_EQ(1u, iteratorReport.size());
+    ASSERT_EQ(0u, iteratorReport[0].offset);
+
+    FastaParser<biopp::NucSequence> strictResidues(file);
+    ASSERT_ANY_THROW(strictResidues.getNextSequence(title, sequence));
+}
+
+struct DecodedSequence
+{
+    std::string residues;
+    bool viaDecoder;
+
+    DecodedSequence()
+        : viaDecoder(false)
+    {}
+
+    std::string getString() const
+    {
+        return residues;
+    }
+};
+
+namespace bioppFiler
+{
+template<>
+struct SequenceDecoder<DecodedSequence>
+{
+    static void decode(const StringView& raw, DecodedSequence& sequence)
+    {
+        sequence.residues = raw.str();
+        sequence.viaDecoder = true;
+    }
+    static bool tryDecode(const StringView& raw, DecodedSequence& sequence, std::string&)
+    {
+        decode(raw, sequence);
+        return true;
+    }
+};
+}
+
+TEST(FastaFormatTest, SequenceDecoder)
+{
+    const std::string file("Decoder.txt");
+    {
+        std::ofstream of(file.c_str());
+        of << ">first\nACGT\nAC\n>second\nGGa\n";
+    }
+
+    std::string title;
+    DecodedSequence sequence;
+    FastaParser<DecodedSequence> fp(file);
+    ASSERT_TRUE(fp.getNextSequence(title, sequence));
+    ASSERT_TRUE(sequence.viaDecoder);
+    ASSERT_EQ("ACGTAC", sequence.getString());
+
+    FastaParser<DecodedSequence>::iterator it = fp.begin();
+    ASSERT_TRUE(it != fp.end());
+    ASSERT_TRUE(it->getSequence().viaDecoder);
+    ASSERT_EQ("GGa", it->getSequence().getString());
+
+    FastaCollection<DecodedSequence> collection(file, 1);
+    ASSERT_EQ(2u, collection.size());
+    ASSERT_TRUE(collection.getSequence(0).viaDecoder);
+    ASSERT_EQ("GGa", collection.getSequence(1).getString());
+}
+
+TEST(FastaFormatTest, BioppDecoder)
+{
+    const std::string raw("acgTTn");
+
+    biopp::NucSequence nuc;
+    SequenceDecoder<biopp::NucSequence>::decode(StringView(raw), nuc);
+    ASSERT_EQ("ACGUUN", nuc.getString());
+
+    biopp::PseudonucSequence pseudonuc;
+    SequenceDecoder<biopp::PseudonucSequence>::decode(StringView("ryTk-", 5), pseudonuc);
+    ASSERT_EQ("RYUK-", pseudonuc.getString());
+
+    biopp::AminoSequence amino;
+    SequenceDecoder<biopp::AminoSequence>::decode(StringView("mktAy*", 6), amino);
+    ASSERT_EQ("MKTAY*", amino.getString());
+
+    // decoding starts over, and stops at the first residue out of the alphabet
+    ASSERT_THROW(SequenceDecoder<biopp::NucSequence>::decode(StringView("ACXT", 4), nuc), InvalidSequenceError);
+    std::string error;
+    ASSERT_FALSE(SequenceDecoder<biopp::NucSequence>::tryDecode(StringView("ACXT", 4), nuc, error));
+    ASSERT_EQ("invalid residue 'X'", error);
+    ASSERT_TRUE(SequenceDecoder<biopp::AminoSequence>::tryDecode(StringView("mk", 2), amino, error));
+    ASSERT_EQ("MK", amino.getString());
+    SequenceDecoder<biopp::NucSequence>::decode(StringView("gat", 3), nuc);
+    ASSERT_EQ("GAU", nuc.getString());
+}
+
+static unsigned int keysLeft;
+
+static std::string failingKey(const std::string& description, const std::string& sequence)
+{
+    if (keysLeft-- == 0)
+        throw std::runtime_error("key failed");
+    return FastaSorter<biopp::NucSequence>::idKey(description, sequence);
+}
+
+static unsigned int countRuns()
+{
+    unsigned int runs = 0;
+    DIR* const dir = opendir(".");
+    while (const dirent* entry = readdir(dir))
+        if (std::string(entry->d_name).find(".biopp-filer-run-") == 0)
+            ++runs;
+    closedir(dir);
+    return runs;
+}
+
+TEST(FastaSorterTest, SortAndPartition)
+{
+    const std::string file("Unsorted.txt");
+    const unsigned int records = 1000;
+
+    std::ofstream of(file.c_str());
+    for (unsigned int i = 0; i < records; ++i)
+    {
+        const unsigned int id = (i * 7919) % records;
+        of << ">id" << std::setw(4) << std::setfill('0') << id << " record " << i << "\n";
+        of << std::string(1 + id % 13, "ACGT"[i % 4]) << "\n";
+    }
+    of.close();
+
+    FastaSorter<biopp::NucSequence> sorter(1024);
+
+    sorter.sort(file, "SortedById.txt");
+    FastaParser<biopp::NucSequence> byId("SortedById.txt");
+    std::string previous;
+    unsigned int count = 0;
+    for (FastaParser<biopp::NucSequence>::iterator it = byId.begin(); it != byId.end(); ++it, ++count)
+    {
+        ASSERT_LT(previous, it->getDescription());
+        previous = it->getDescription();
+    }
+    ASSERT_EQ(records, count);
+
+    sorter.sort(file, "SortedByLength.txt", FastaSorter<biopp::NucSequence>::ByLength);
+    FastaParser<biopp::NucSequence> byLength("SortedByLength.txt");
+    size_t previousLength = 0;
+    count = 0;
+    for (FastaParser<biopp::NucSequence>::iterator it = byLength.begin(); it != byLength.end(); ++it, ++count)
+    {
+        ASSERT_LE(previousLength, it->length());
+        previousLength = it->length();
+    }
+    ASSERT_EQ(records, count);
+
+    std::vector<std::string> shards;
+    shards.push_back("Shard0.txt");
+    shards.push_back("Shard1.txt");
+    shards.push_back("Shard2.txt");
+    sorter.partition(file, shards);
+
+    std::set<std::string> ids;
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        FastaParser<biopp::NucSequence> shard(shards[i]);
+        for (FastaParser<biopp::NucSequence>::iterator it = shard.begin(); it != shard.end(); ++it)
+            ids.insert(FastaSorter<biopp::NucSequence>::idKey(it->getDescription(), it->getSequenceString()));
+    }
+    ASSERT_EQ(records, ids.size());
+    ASSERT_THROW(sorter.partition(file, std::vector<std::string>()), BioppFilerException);
+
+    // a failure half way leaves no temporary runs behind
+    ASSERT_EQ(0u, countRuns());
+    keysLeft = records / 2;
+    ASSERT_ANY_THROW(sorter.sort(file, "SortedFailing.txt", failingKey));
+    ASSERT_EQ(0u, countRuns());
+    keysLeft = records + records / 2; // fails while merging
+    ASSERT_ANY_THROW(sorter.sort(file, "SortedFailing.txt", failingKey));
+    ASSERT_EQ(0u, countRuns());
+}
+
+TEST(FastaFormatTest, Filter)
+{
+    const std::string file("Filter.txt");
+
+    std::ofstream of(file.c_str());
+    of << ">sp|P1 kinase\nATCG\nATCG\n>tr|P2 kinase\nAT\n>sp|P3 ligase\nATCGATCGATCG\n"
+       << ">sp|P4 kinase\nA;comentario\nTTT\n\nGGG\n>sp|P5 ligase\nAAAAA\n";
+    of.close();
+
+    std::string title;
+    biopp::NucSequence sequence;
+    std::list<std::string> titles;
+
+    RecordFilter byId;
+    byId.addId("sp|P3");
+    byId.addId("tr|P2");
+    FastaParser<biopp::NucSequence> fp(file);
+    fp.setFilter(&byId);
+    std::list<biopp::NucSequence> sequences;
+    while (fp.getNextSequence(title, sequence))
+    {
+        titles.push_back(title);
+        sequences.push_back(sequence);
+    }
+    ASSERT_EQ(2u, titles.size());
+    ASSERT_EQ("tr|P2 kinase", titles.front());
+    ASSERT_EQ("sp|P3 ligase", titles.back());
+    ASSERT_EQ("AUCGAUCGAUCG", sequences.back().getString());
+
+    RecordFilter kinases;
+    kinases.setPrefix("sp|");
+    kinases.setRegex("kin.se");
+    kinases.setLengthBounds(3, 8);
+    fp.reset();
+    fp.setFilter(&kinases);
+    titles.clear();
+    sequences.clear();
+    while (fp.getNextSequence(title, sequence))
+    {
+        titles.push_back(title);
+        sequences.push_back(sequence);
+    }
+    ASSERT_EQ(2u, titles.size());
+    ASSERT_EQ("sp|P1 kinase", titles.front());
+    ASSERT_EQ("AUCGAUCG", sequences.front().getString());
+    ASSERT_EQ("sp|P4 kinase", titles.back());
+    ASSERT_EQ("AUUU", sequences.back().getString());
+
+    RecordFilter headerless;
+    headerless.setLengthBounds(3, 3);
+    fp.reset();
+    fp.setFilter(&headerless);
+    ASSERT_TRUE(fp.getNextSequence(title, sequence));
+    ASSERT_EQ("", title);
+    ASSERT_EQ("GGG", sequence.getString());
+    ASSERT_FALSE(fp.getNextSequence(title, sequence));
+
+    fp.reset();
+    fp.setFilter(NULL);
+    titles.clear();
+    while (fp.getNextSequence(title, sequence))
+        titles.push_back(title);
+    ASSERT_EQ(6u, titles.size());
+}
+
+TEST(KmerScannerTest, Kmers)
+{
+    const std::string file("Kmers.txt");
+
+    std::ofstream of(file.c_str());
+    of << ">sequence_1\nACGTN\nacg\ntacgT\n>sequence_2\nAC\nGT\n";
+    of.close();
+
+    // k-mers come straight from the scanned lines, spanning the line breaks
+    KmerScanner scanner(3);
+    std::list<std::string> kmers;
+    std::list<size_t> positions;
+    auto sink = makeKmerSink(scanner, [&](KmerScanner::Word kmer, size_t position)
+    {
+        kmers.push_back(KmerScanner::decode(kmer, 3));
+        positions.push_back(position);
+    });
+
+    FastaParser<biopp::NucSequence> fp(file);
+    std::string title;
+    ASSERT_TRUE(fp.scanNextSequence(title, sink));
+    ASSERT_EQ("sequence_1", title);
+
+    // ACGTN|ACGTACGT: the N breaks every k-mer spanning it
+    const char* const expected[] = {"ACG", "CGT", "ACG", "CGT", "GTA", "TAC", "ACG", "CGT"};
+    const size_t expectedPositions[] = {0, 1, 5, 6, 7, 8, 9, 10};
+    ASSERT_EQ(8u, kmers.size());
+    std::list<size_t>::const_iterator itPosition = positions.begin();
+    size_t i = 0;
+    for (std::list<std::string>::const_iterator it = kmers.begin(); it != kmers.end(); ++it, ++itPosition, ++i)
+    {
+        ASSERT_EQ(expected[i], *it);
+        ASSERT_EQ(expectedPositions[i], *itPosition);
+    }
+
+    // each record starts over
+    kmers.clear();
+    positions.clear();
+    ASSERT_TRUE(fp.scanNextSequence(title, sink));
+    ASSERT_EQ("sequence_2", title);
+    ASSERT_EQ(2u, kmers.size());
+    ASSERT_EQ("ACG", kmers.front());
+    ASSERT_EQ(0u, positions.front());
+    ASSERT_EQ("CGT", kmers.back());
+    ASSERT_EQ(1u, positions.back());
+    ASSERT_FALSE(fp.scanNextSequence(title, sink));
+
+    KmerScanner::Word kmer;
+    size_t position;
+    KmerScanner canonical(3, true);
+    const std::string palindrome("CGT");
+    canonical.setSequence(StringView(palindrome));
+    ASSERT_TRUE(canonical.getNextKmer(kmer, position));
+    ASSERT_EQ("ACG", KmerScanner::decode(kmer, 3));
+
+    KmerScanner longest(32);
+    const std::string bases("ACGTTGCAACGTTGCAACGTTGCAACGTTGCAG");
+    longest.setSequence(StringView(bases));
+    ASSERT_TRUE(longest.getNextKmer(kmer, position));
+    ASSERT_EQ(bases.substr(0, 32), KmerScanner::decode(kmer, 32));
+    ASSERT_TRUE(longest.getNextKmer(kmer, position));
+    ASSERT_EQ(bases.substr(1, 32), KmerScanner::decode(kmer, 32));
+    ASSERT_FALSE(longest.getNextKmer(kmer, position));
+}
+
+TEST(KmerScannerTest, Minimizers)
+{
+    std::string bases;
+    unsigned int seed = 17;
+    for (unsigned int i = 0; i < 500; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        bases += "ACGT"[(seed >> 16) % 4];
+    }
+
+    const unsigned int k = 5;
+    const unsigned int w = 4;
+
+    // brute force: minimum hash of every window, leftmost on ties
+    std::vector<KmerScanner::Word> kmers;
+    KmerScanner scanner(k, true);
+    scanner.setSequence(StringView(bases));
+    KmerScanner::Word kmer;
+    size_t position;
+    while (scanner.getNextKmer(kmer, position))
+        kmers.push_back(kmer);
+
+    std::vector<size_t> expected;
+    for (size_t first = 0; first + w <= kmers.size(); ++first)
+    {
+        size_t best = first;
+        for (size_t j = first; j < first + w; ++j)
+            if (MinimizerScanner::hash(kmers[j]) < MinimizerScanner::hash(kmers[best]))
+                best = j;
+        if (expected.empty() || expected.back() != best)
+            expected.push_back(best);
+    }
+
+    MinimizerScanner minimizers(k, w);
+    minimizers.setSequence(StringView(bases));
+    std::vector<size_t> found;
+    while (minimizers.getNextMinimizer(kmer, position))
+    {
+        ASSERT_EQ(kmers[position], kmer);
+        found.push_back(position);
+    }
+    ASSERT_EQ(expected, found);
+
+    // fed piece by piece, the windows span the pieces
+    minimizers.setSequence(StringView());
+    found.clear();
+    for (size_t first = 0; first < bases.size(); first += 7)
+    {
+        minimizers.appendSequence(StringView(bases.data() + first, std::min<size_t>(7, bases.size() - first)));
+        while (minimizers.getNextMinimizer(kmer, position))
+            found.push_back(position);
+    }
+    ASSERT_EQ(expected, found);
+}
+
+/*
+ * Keeps residues exactly as given, case included.
+ */
+struct RawSequence
+{
+    std::string residues;
+
+    RawSequence(const std::string& str = "")
+        : residues(str)
+    {}
+
+    std::string getString() const
+    {
+        return residues;
+    }
+};
+
+TEST(FastaFormatTest, SaveTransforms)
+{
+    const std::string file("SaveTransforms.txt");
+    std::string longSequence;
+    for (unsigned int i = 0; i < 30; ++i)
+        longSequence += "ACgt";
+
+    {
+        FastaSaver<RawSequence> fs(file);
+        fs.setTransforms(SequenceTransform::ReverseComplement | SequenceTransform::TToU);
+        fs.saveNextSequence("revcomp", RawSequence("AAcgtN"));
+        fs.saveNextSequence("long", RawSequence(longSequence));
+
+        fs.setTransforms(SequenceTransform::Mask | SequenceTransform::UToT);
+        fs.saveNextSequence("masked", RawSequence("ACGUacguACGU"));
+
+        fs.setTransforms(SequenceTransform::LowerCase);
+        fs.saveNextSequence("lower", RawSequence("ACGUN"));
+
+        fs.setTransforms(SequenceTransform::None);
+        fs.saveNextSequence("plain", RawSequence("ACgu"));
+    }
+
+    std::ifstream is(file.c_str());
+    std::string line;
+    std::list<std::string> lines;
+    while (std::getline(is, line))
+        lines.push_back(line);
+
+    std::string longExpected;
+    for (unsigned int i = 0; i < 30; ++i)
+        longExpected += "acGU";
+
+    const std::string expected[] =
+    {
+        ">revcomp", "NacgUU",
+        ">long", longExpected.substr(0, 50), longExpected.substr(50, 50), longExpected.substr(100),
+        ">masked", "ACGTNNNNACGT",
+        ">lower", "acgun",
+        ">plain", "ACgu"
+    };
+    ASSERT_EQ(sizeof(expected) / sizeof(expected[0]), lines.size());
+    size_t i = 0;
+    for (std::list<std::string>::const_iterator it = lines.begin(); it != lines.end(); ++it, ++i)
+        ASSERT_EQ(expected[i], *it);
+}
+
+TEST(FastaFormatTest, TransformBlocks)
+{
+    // long enough for several 16 residues blocks plus a tail; one block has
+    // residues out of the letters range, which must take the scalar path
+    std::string sequence;
+    for (unsigned int i = 0; i < 77; ++i)
+        sequence += "ACGTURYKMBVDHSWNacgturykmbvdhswnXZ"[(i * 7) % 34];
+    sequence[40] = '*';
+    sequence[41] = '-';
+
+    // the masked residues, written in lower case, are the reference for 'mask'
+    SoftMask mask;
+    mask.add(3, 5);
+    mask.add(14, 37);
+    mask.add(50, 51);
+    mask.add(60, 90);
+    std::string softened(sequence);
+    mask.restore(softened);
+
+    const unsigned int transforms[] =
+    {
+        SequenceTransform::None,
+        SequenceTransform::ReverseComplement,
+        SequenceTransform::UToT | SequenceTransform::UpperCase,
+        SequenceTransform::TToU | SequenceTransform::LowerCase,
+        SequenceTransform::ReverseComplement | SequenceTransform::Mask,
+        SequenceTransform::ReverseComplement | SequenceTransform::TToU | SequenceTransform::UpperCase
+    };
+
+    for (size_t t = 0; t < sizeof(transforms) / sizeof(transforms[0]); ++t)
+    {
+        const SequenceTransform transform(transforms[t]);
+        for (size_t from = 0; from < 5; ++from)
+            for (size_t length = 0; from + length <= sequence.size(); ++length)
+            {
+                std::string expected;
+                for (size_t i = 0; i < length; ++i)
+                    transform.apply(sequence, from + i, 1, expected);
+
+                std::string block("prefix");
+                transform.apply(sequence, from, length, block);
+                ASSERT_EQ("prefix" + expected, block);
+
+                std::string expectedMasked;
+                for (size_t i = 0; i < length; ++i)
+                    transform.apply(softened, from + i, 1, expectedMasked);
+
+                std::string masked("prefix");
+                transform.apply(sequence, from, length, mask, masked);
+                ASSERT_EQ("prefix" + expectedMasked, masked);
+            }
+    }
+
+#if defined(BIOPP_FILER_SSSE3)
+    // the blocks above went through the SSSE3 lookups, even in a build
+    // without -mssse3, on every CPU that has them
+    ASSERT_EQ(__builtin_cpu_supports("ssse3") != 0, SequenceTransform::usesSsse3());
+#endif
+
+    ASSERT_THROW(SequenceTransform(SequenceTransform::UToT | SequenceTransform::TToU), BioppFilerException);
+    ASSERT_THROW(SequenceTransform(SequenceTransform::UpperCase | SequenceTransform::LowerCase), BioppFilerException);
+}
+
+TEST(FastaFormatTest, SoftMask)
+{
+    const std::string file("SoftMask.txt");
+    const std::string saved("SoftMaskSaved.txt");
+
+    std::string masked;
+    for (unsigned int i = 0; i < 20; ++i)
+        masked += "ACgtnnAC";
+
+    std::ofstream of(file.c_str());
+    of << ">sequence_1\n" << masked.substr(0, 70) << "\n" << masked.substr(70) << "\n>sequence_2\nACGT\n";
+    of.close();
+
+    FastaParser<RawSequence> fp(file);
+    std::string title;
+    RawSequence sequence;
+    SoftMask mask;
+
+    ASSERT_TRUE(fp.getNextSequence(title, sequence, mask));
+    ASSERT_EQ(20u, mask.size());
+    ASSERT_EQ(80u, mask.maskedLength());
+    ASSERT_EQ(2u, mask[0].begin);
+    ASSERT_EQ(6u, mask[0].end);
+    for (size_t i = 0; i < sequence.residues.size(); ++i)
+        ASSERT_TRUE(std::isupper(sequence.residues[i]));
+
+    {
+        FastaSaver<RawSequence> fs(saved);
+        fs.saveNextSequence(title, sequence, mask);
+
+        fs.setTransforms(SequenceTransform::ReverseComplement);
+        fs.saveNextSequence("reverse", sequence, mask);
+
+        fs.setTransforms(SequenceTransform::ReverseComplement | SequenceTransform::Mask);
+        fs.saveNextSequence("hard", sequence, mask);
+
+        fs.setTransforms(SequenceTransform::UpperCase);
+        fs.saveNextSequence("upper", sequence, mask);
+    }
+
+    FastaParser<RawSequence> roundTrip(saved);
+    RawSequence restored;
+    ASSERT_TRUE(roundTrip.getNextSequence(title, restored));
+    ASSERT_EQ(masked, restored.residues);
+
+    std::string reversed;
+    for (unsigned int i = 0; i < 20; ++i)
+        reversed += "GTnnacGT";
+    ASSERT_TRUE(roundTrip.getNextSequence(title, restored));
+    ASSERT_EQ(reversed, restored.residues);
+
+    std::string hard;
+    std::string upper;
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        hard += "GTNNNNGT";
+        upper += "ACGTNNAC";
+    }
+    ASSERT_TRUE(roundTrip.getNextSequence(title, restored));
+    ASSERT_EQ(hard, restored.residues);
+    ASSERT_TRUE(roundTrip.getNextSequence(title, restored));
+    ASSERT_EQ(upper, restored.residues);
+
+    ASSERT_TRUE(fp.getNextSequence(title, sequence, mask));
+    ASSERT_TRUE(mask.empty());
+}